@@ -0,0 +1,417 @@
+// blkdev.c — mmap'd disk-image backend (see blkdev.h)
+
+#ifndef _WIN32
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, flock, realpath under -std=c2x
+#endif
+
+#include "blkdev.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void blkdevMarkDirty(blkdev_t *dev, uint32_t lba, uint32_t count) {
+  if (lba >= dev->nSectors)
+    return;
+  if (count > dev->nSectors - lba)
+    count = dev->nSectors - lba;
+  memset(&dev->dirty[lba], 1, count);
+}
+
+uint8_t *blkdevSectorForWrite(blkdev_t *dev, uint32_t lba) {
+  if (!dev->ovl)
+    return blkdevSector(dev, lba);
+  uint8_t *slot = dev->ovlData + (size_t)lba * dev->sectorSize;
+  if (!blkdevOverlayHas(dev, lba)) {
+    // Copy up so a partial write keeps the rest of the base sector
+    memcpy(slot, dev->base + (size_t)lba * dev->sectorSize, dev->sectorSize);
+    dev->ovlBitmap[lba >> 3] |= (uint8_t)(1u << (lba & 7));
+  }
+  return slot;
+}
+
+#ifndef _WIN32
+
+static void blkdevReset(blkdev_t *dev) {
+  memset(dev, 0, sizeof(*dev));
+  dev->fd = -1;
+  dev->ovlFd = -1;
+}
+
+int blkdevOpen(blkdev_t *dev, const char *path, size_t size,
+               uint32_t sectorSize, int readOnly) {
+  blkdevReset(dev);
+  dev->sectorSize = sectorSize;
+
+  if (path && path[0]) {
+    dev->fd = open(path, readOnly ? O_RDONLY : O_RDWR);
+    if (dev->fd < 0 && errno != ENOENT)
+      return -1;
+  }
+
+  if (dev->fd >= 0) {
+    struct stat sb;
+    if (fstat(dev->fd, &sb) < 0)
+      goto fail;
+    if (size == 0)
+      size = (size_t)sb.st_size;
+    // Touching a mapped page past EOF raises SIGBUS, so refuse short images
+    if ((size_t)sb.st_size < size || size == 0) {
+      errno = EINVAL;
+      goto fail;
+    }
+    dev->fromFile = 1;
+    dev->shared = !readOnly;
+    dev->base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     dev->shared ? MAP_SHARED : MAP_PRIVATE, dev->fd, 0);
+  } else {
+    if (size == 0) {
+      errno = ENOENT;
+      return -1;
+    }
+    dev->base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (dev->base == MAP_FAILED) {
+    dev->base = NULL;
+    goto fail;
+  }
+
+  dev->size = size;
+  dev->nSectors = (uint32_t)(size / sectorSize);
+  dev->dirty = (uint8_t *)calloc(dev->nSectors ? dev->nSectors : 1, 1);
+  if (!dev->dirty)
+    goto fail;
+  return 0;
+
+fail:;
+  int err = errno;
+  if (dev->base)
+    munmap(dev->base, size);
+  if (dev->fd >= 0)
+    close(dev->fd);
+  blkdevReset(dev);
+  errno = err;
+  return -1;
+}
+
+int blkdevOpenOverlay(blkdev_t *dev, const char *basePath,
+                      const char *ovlPath, size_t size, uint32_t sectorSize) {
+  blkdev_ovl_hdr_t hdr;
+  struct stat sb;
+  int err, fresh = 0;
+
+  int fd = open(ovlPath, O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+    return -1;
+  // Two instances writing one overlay would corrupt each other
+  if (flock(fd, LOCK_EX | LOCK_NB) < 0 || fstat(fd, &sb) < 0)
+    goto fail_fd;
+
+  fresh = sb.st_size == 0;
+  if (!fresh) {
+    if (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+        memcmp(hdr.magic, BLKDEV_OVL_MAGIC, sizeof(BLKDEV_OVL_MAGIC)) != 0 ||
+        hdr.version != BLKDEV_OVL_VERSION ||
+        (sectorSize && sectorSize != hdr.sectorSize) ||
+        (size && size != (size_t)hdr.nSectors * hdr.sectorSize) ||
+        (uint64_t)sb.st_size <
+            hdr.dataOffset + (uint64_t)hdr.nSectors * hdr.sectorSize) {
+      errno = EINVAL;
+      goto fail_fd;
+    }
+    sectorSize = hdr.sectorSize;
+    size = (size_t)hdr.nSectors * hdr.sectorSize;
+    if (!basePath)
+      basePath = hdr.basePath;
+  } else if (!basePath || !sectorSize) {
+    errno = EINVAL;
+    goto fail_fd;
+  }
+
+  // Never written through: pages stay shared with every other instance
+  if (blkdevOpen(dev, basePath, size, sectorSize, 1) < 0)
+    goto fail_fd;
+
+  if (fresh) {
+    char abs[PATH_MAX];
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, BLKDEV_OVL_MAGIC, sizeof(BLKDEV_OVL_MAGIC));
+    hdr.version = BLKDEV_OVL_VERSION;
+    hdr.sectorSize = sectorSize;
+    hdr.nSectors = dev->nSectors;
+    hdr.bitmapOffset = (sizeof(hdr) + 63) & ~63u;
+    hdr.dataOffset = (hdr.bitmapOffset + (dev->nSectors + 7) / 8 + 4095) &
+                     ~(uint64_t)4095;
+    // Absolute, so a later commit works from any directory
+    const char *rec = realpath(basePath, abs) ? abs : basePath;
+    if (strlen(rec) >= sizeof(hdr.basePath)) {
+      errno = ENAMETOOLONG;
+      goto fail_dev;
+    }
+    memcpy(hdr.basePath, rec, strlen(rec));
+    if (ftruncate(fd, (off_t)(hdr.dataOffset + dev->size)) < 0 ||
+        pwrite(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr))
+      goto fail_dev;
+  }
+
+  dev->ovlSize = (size_t)hdr.dataOffset + dev->size;
+  dev->ovl = mmap(NULL, dev->ovlSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (dev->ovl == MAP_FAILED) {
+    dev->ovl = NULL;
+    goto fail_dev;
+  }
+  dev->ovlBitmap = dev->ovl + hdr.bitmapOffset;
+  dev->ovlData = dev->ovl + hdr.dataOffset;
+  dev->ovlFd = fd;
+  return 0;
+
+fail_dev:
+  err = errno;
+  blkdevClose(dev);
+  errno = err;
+fail_fd:
+  err = errno;
+  if (fresh)
+    unlink(ovlPath);
+  close(fd);
+  errno = err;
+  return -1;
+}
+
+int blkdevFlush(blkdev_t *dev) {
+  if (!dev->base)
+    return 0;
+  if (!dev->shared && !dev->ovl) {
+    memset(dev->dirty, 0, dev->nSectors);
+    return 0;
+  }
+
+  // With an overlay the dirty sectors live in its slots, not in the base
+  uint8_t *map = dev->ovl ? dev->ovl : dev->base;
+  size_t off0 = dev->ovl ? (size_t)(dev->ovlData - dev->ovl) : 0;
+
+  // msync wants page-aligned ranges: coalesce runs of dirty sectors and round
+  // each run out to whole pages.
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  int rc = 0, any = 0;
+  uint32_t lba = 0;
+  while (lba < dev->nSectors) {
+    if (!dev->dirty[lba]) {
+      lba++;
+      continue;
+    }
+    uint32_t end = lba;
+    while (end < dev->nSectors && dev->dirty[end])
+      end++;
+    size_t from = (off0 + (size_t)lba * dev->sectorSize) / page * page;
+    size_t to = off0 + (size_t)end * dev->sectorSize;
+    if (msync(map + from, to - from, MS_SYNC) < 0)
+      rc = -1;
+    memset(&dev->dirty[lba], 0, end - lba);
+    lba = end;
+    any = 1;
+  }
+  // Bitmap last: a set bit must never point at a slot that is not on disk
+  if (any && dev->ovl) {
+    size_t to = (size_t)(dev->ovlBitmap - dev->ovl) + (dev->nSectors + 7) / 8;
+    if (msync(dev->ovl, to, MS_SYNC) < 0)
+      rc = -1;
+  }
+  return rc;
+}
+
+void blkdevClose(blkdev_t *dev) {
+  if (!dev->base)
+    return;
+  blkdevFlush(dev);
+  munmap(dev->base, dev->size);
+  if (dev->fd >= 0)
+    close(dev->fd);
+  if (dev->ovl)
+    munmap(dev->ovl, dev->ovlSize);
+  if (dev->ovlFd >= 0)
+    close(dev->ovlFd);
+  free(dev->dirty);
+  blkdevReset(dev);
+}
+
+int blkdevCreate(const char *path, uint64_t size) {
+  int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    return -1;
+  if (ftruncate(fd, (off_t)size) < 0) {
+    int err = errno;
+    close(fd);
+    unlink(path);
+    errno = err;
+    return -1;
+  }
+  close(fd);
+  return 0;
+}
+
+long blkdevOverlayCommit(blkdev_t *dev) {
+  if (!dev->ovl) {
+    errno = EINVAL;
+    return -1;
+  }
+  const blkdev_ovl_hdr_t *hdr = (const blkdev_ovl_hdr_t *)dev->ovl;
+  int fd = open(hdr->basePath, O_WRONLY);
+  if (fd < 0)
+    return -1;
+
+  long n = 0;
+  for (uint32_t lba = 0; lba < dev->nSectors; lba++) {
+    if (!blkdevOverlayHas(dev, lba))
+      continue;
+    off_t off = (off_t)lba * dev->sectorSize;
+    if (pwrite(fd, dev->ovlData + off, dev->sectorSize, off) !=
+        (ssize_t)dev->sectorSize)
+      goto fail;
+    n++;
+  }
+  if (fsync(fd) < 0)
+    goto fail;
+  close(fd);
+
+  // The base holds the data now: clear the bitmap, then drop the slots'
+  // blocks by truncating the data area away and extending it again
+  memset(dev->ovlBitmap, 0, (dev->nSectors + 7) / 8);
+  memset(dev->dirty, 0, dev->nSectors);
+  if (msync(dev->ovl, (size_t)(dev->ovlData - dev->ovl), MS_SYNC) < 0 ||
+      ftruncate(dev->ovlFd, (off_t)(dev->ovlData - dev->ovl)) < 0 ||
+      ftruncate(dev->ovlFd, (off_t)dev->ovlSize) < 0)
+    return -1;
+  return n;
+
+fail:;
+  int err = errno;
+  close(fd);
+  errno = err;
+  return -1;
+}
+
+#else // _WIN32: no mmap — keep a heap copy and write dirty sectors back
+
+int blkdevOpen(blkdev_t *dev, const char *path, size_t size,
+               uint32_t sectorSize, int readOnly) {
+  memset(dev, 0, sizeof(*dev));
+  dev->sectorSize = sectorSize;
+
+  if (path && path[0]) {
+    dev->file = fopen(path, readOnly ? "rb" : "rb+");
+    if (!dev->file && errno != ENOENT)
+      return -1;
+  }
+  if (dev->file) {
+    fseek(dev->file, 0, SEEK_END);
+    long fsize = ftell(dev->file);
+    rewind(dev->file);
+    if (size == 0)
+      size = (size_t)fsize;
+    if (fsize < 0 || (size_t)fsize < size || size == 0) {
+      fclose(dev->file);
+      dev->file = NULL;
+      errno = EINVAL;
+      return -1;
+    }
+  } else if (size == 0) {
+    errno = ENOENT;
+    return -1;
+  }
+
+  dev->base = (uint8_t *)calloc(size, 1);
+  dev->nSectors = (uint32_t)(size / sectorSize);
+  dev->dirty = (uint8_t *)calloc(dev->nSectors ? dev->nSectors : 1, 1);
+  if (!dev->base || !dev->dirty ||
+      (dev->file && fread(dev->base, 1, size, dev->file) != size)) {
+    free(dev->base);
+    free(dev->dirty);
+    if (dev->file)
+      fclose(dev->file);
+    memset(dev, 0, sizeof(*dev));
+    return -1;
+  }
+  dev->size = size;
+  dev->fromFile = dev->file != NULL;
+  dev->shared = dev->file && !readOnly;
+  return 0;
+}
+
+int blkdevFlush(blkdev_t *dev) {
+  int rc = 0;
+  for (uint32_t lba = 0; lba < dev->nSectors; lba++) {
+    if (!dev->dirty[lba])
+      continue;
+    dev->dirty[lba] = 0;
+    if (!dev->shared)
+      continue;
+    if (fseek(dev->file, (long)lba * dev->sectorSize, SEEK_SET) != 0 ||
+        fwrite(blkdevSector(dev, lba), 1, dev->sectorSize, dev->file) !=
+            dev->sectorSize)
+      rc = -1;
+  }
+  if (dev->shared && fflush(dev->file) != 0)
+    rc = -1;
+  return rc;
+}
+
+void blkdevClose(blkdev_t *dev) {
+  if (!dev->base)
+    return;
+  blkdevFlush(dev);
+  if (dev->file)
+    fclose(dev->file);
+  free(dev->base);
+  free(dev->dirty);
+  memset(dev, 0, sizeof(*dev));
+}
+
+int blkdevCreate(const char *path, uint64_t size) {
+  FILE *f = fopen(path, "rb");
+  if (f) {
+    fclose(f);
+    errno = EEXIST;
+    return -1;
+  }
+  f = fopen(path, "wb");
+  if (!f)
+    return -1;
+  // No ftruncate: seek to the last byte and write it
+  if (size && (_fseeki64(f, (long long)size - 1, SEEK_SET) != 0 ||
+               fputc(0, f) == EOF)) {
+    fclose(f);
+    remove(path);
+    errno = EIO;
+    return -1;
+  }
+  return fclose(f);
+}
+
+int blkdevOpenOverlay(blkdev_t *dev, const char *basePath,
+                      const char *ovlPath, size_t size, uint32_t sectorSize) {
+  (void)basePath;
+  (void)ovlPath;
+  (void)size;
+  (void)sectorSize;
+  memset(dev, 0, sizeof(*dev));
+  errno = ENOSYS;
+  return -1;
+}
+
+long blkdevOverlayCommit(blkdev_t *dev) {
+  (void)dev;
+  errno = ENOSYS;
+  return -1;
+}
+
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ─── Block-device backend ─────────────────────────────────────────────────────
+// Shared by the SDL emulator (floppy.c) and the ncurses debugger
+// (debugger.c). The image file is mmap'd: sectors are faulted in by the
+// kernel on first touch instead of being read up front, and guest writes land
+// directly in the page cache. Writers mark sectors dirty; blkdevFlush()
+// msyncs only the pages that cover dirty sectors.
+//
+//   read-write  → MAP_SHARED   (writes persist to the image)
+//   read-only   → MAP_PRIVATE  (writes are visible to the guest, then lost)
+//   no image    → anonymous    (blank disk, nothing persists)
+//   overlay     → base MAP_PRIVATE + overlay file MAP_SHARED (see below)
+//
+// Overlay images let many instances share one read-only base. The overlay file
+// is a header, a one-bit-per-sector bitmap and a slot for every sector at
+// dataOffset + lba * sectorSize. Slots are only written when the guest first
+// writes that sector, so the file stays sparse and creating one is O(1).
+
+typedef struct blkdev_t {
+  uint8_t *base;        // start of the mapped image
+  size_t   size;        // bytes mapped
+  uint32_t sectorSize;  // bytes per sector
+  uint32_t nSectors;    // size / sectorSize
+  uint8_t *dirty;       // one byte per sector, set by blkdevMarkDirty
+#ifdef _WIN32
+  FILE    *file;        // no mmap: heap copy, dirty sectors written back
+#else
+  int      fd;          // backing file, -1 when anonymous
+#endif
+  int      fromFile;    // 0 for a blank anonymous disk
+  int      shared;      // 1 when writes reach the image file
+  uint8_t *ovl;         // mapped overlay file, NULL when not layered
+  size_t   ovlSize;     // bytes mapped
+  uint8_t *ovlBitmap;   // bit set = sector lives in the overlay
+  uint8_t *ovlData;     // sector slots, indexed by LBA
+#ifndef _WIN32
+  int      ovlFd;
+#endif
+} blkdev_t;
+
+// On-disk overlay header, host byte order, at offset 0 of the overlay file
+#define BLKDEV_OVL_MAGIC   "BB65OVL"
+#define BLKDEV_OVL_VERSION 1
+typedef struct blkdev_ovl_hdr_t {
+  char     magic[8];        // BLKDEV_OVL_MAGIC, NUL padded
+  uint32_t version;
+  uint32_t sectorSize;
+  uint32_t nSectors;
+  uint32_t bitmapOffset;    // from start of file
+  uint64_t dataOffset;      // page aligned, slot for LBA 0
+  char     basePath[1024];  // base image the overlay was created over
+} blkdev_ovl_hdr_t;
+
+// Map `path` as a disk of `size` bytes (0 = use the file's size).
+// A NULL/empty path, or a file that does not exist, gives a blank anonymous
+// disk of `size` bytes. Returns 0 on success, -1 on error (errno set).
+extern int blkdevOpen(blkdev_t *dev, const char *path, size_t size,
+                      uint32_t sectorSize, int readOnly);
+
+// Layer `ovlPath` over the read-only base image `basePath`. The overlay is
+// created if missing. A NULL basePath uses the path recorded in an existing
+// overlay, and size/sectorSize 0 take the values from its header.
+// Not supported on _WIN32 (ENOSYS).
+extern int blkdevOpenOverlay(blkdev_t *dev, const char *basePath,
+                             const char *ovlPath, size_t size,
+                             uint32_t sectorSize);
+
+static inline int blkdevOverlayHas(const blkdev_t *dev, uint32_t lba) {
+  return dev->ovl && (dev->ovlBitmap[lba >> 3] >> (lba & 7) & 1);
+}
+
+// Pointer to the first byte of sector `lba` for reading (no bounds check).
+static inline uint8_t *blkdevSector(blkdev_t *dev, uint32_t lba) {
+  if (blkdevOverlayHas(dev, lba))
+    return dev->ovlData + (size_t)lba * dev->sectorSize;
+  return dev->base + (size_t)lba * dev->sectorSize;
+}
+
+// Pointer to sector `lba` for writing. With an overlay the sector is copied
+// up from the base on first write; otherwise same as blkdevSector.
+extern uint8_t *blkdevSectorForWrite(blkdev_t *dev, uint32_t lba);
+
+extern void blkdevMarkDirty(blkdev_t *dev, uint32_t lba, uint32_t count);
+
+// Write dirty sectors back to the image. Returns 0 or -1 (errno set).
+extern int blkdevFlush(blkdev_t *dev);
+
+// Flush, unmap and close.
+extern void blkdevClose(blkdev_t *dev);
+
+// Create `path` as a zero-filled image of `size` bytes without writing the
+// data (sparse where the filesystem supports it). Fails if it exists.
+extern int blkdevCreate(const char *path, uint64_t size);
+
+// Write every overlay sector into the base image file, then empty the overlay.
+// Returns the number of sectors committed, or -1 on error (errno set).
+extern long blkdevOverlayCommit(blkdev_t *dev);
@@ -1,17 +1,26 @@
-// dispgfx.c — Graphical text-mode display for the 6502 emulator
+// dispgfx.c — Graphical text/bitmap display for the 6502 emulator
 //
 // Architecture
 // ────────────
-//   Main thread   → dispgfxRenderLoop(): SDL events + rendering (~60 fps)
+//   Main thread   → dispgfxRenderLoop(): SDL events + texture upload/present
+//                   (-u tui: dispgfxTuiLoop(), curses via disptui.c)
+//   Raster thread → dispgfxRasterWorker(): rasterizes frames (~60 fps)
 //   Worker thread → dispgfxWorker():     processes CMD-register commands
 //   CPU thread    → (runs the 6502)
 //
 // SDL2 on macOS requires the event/render loop on the main thread, so
 // fake6502Init() must spawn the CPU on a pthread and then call
 // dispgfxRenderLoop() from main.
+//
+// The terminal backend (disptui.c), the video recorder (dispvid.c) and the
+// shared-memory export (dispshm.c) only ever see captured frames.
 
 #include "dispgfx.h"
+#include "dispshm.h"
+#include "disptui.h"
+#include "dispvid.h"
 #include "fake6502.h"
+#include "glyph.h"
 
 #ifdef _MSC_VER
 #include <SDL.h>
@@ -22,17 +31,27 @@
 #include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // ─── Forward declarations ────────────────────────────────────────────────────
 static void dispgfxRender(void);
 static void dispgfxForwardKey(uint8_t k);
+static void dispgfxTuiLoop(void);
 
 // ─── Device register addresses (loaded from device table) ────────────────────
 uint16_t dispgfxCmdRegAddr    = 0;
 uint16_t dispgfxDataRegAddr   = 0;
 uint16_t dispgfxStatusRegAddr = 0;
 
+// ─── Headless options (set by fake6502Init before dispgfxInit) ──────────────
+int         dispgfxHeadless  = 0;
+const char *dispgfxDumpFile  = NULL;
+uint32_t    dispgfxDumpEvery = 0;
+const char *dispgfxRecordFile = NULL;
+int         dispgfxTui       = 0;
+const char *dispgfxShmName   = NULL;
+
 // ─── Internal state ──────────────────────────────────────────────────────────
 static pthread_t workerThread;
 
@@ -40,21 +59,129 @@ static SDL_Window   *sdlWindow   = NULL;
 static SDL_Renderer *sdlRenderer = NULL;
 static SDL_Texture  *sdlTexture  = NULL;
 
-// Pixel buffer: ARGB8888, native resolution (320 × 240)
-static uint32_t framebuf[DISPGFX_WIDTH * DISPGFX_HEIGHT];
+// Pixel buffer: ARGB8888, sized for the largest mode. The current mode uses
+// fbWidth × fbHeight of it, with fbWidth as the pitch (raster thread only).
+static uint32_t framebuf[DISPGFX_MAX_WIDTH * DISPGFX_MAX_HEIGHT];
+static int      fbWidth  = DISPGFX_WIDTH;
+static int      fbHeight = DISPGFX_HEIGHT;
 
-// VRAM / CRAM base addresses (set by 6502 via commands, 0 = not set)
+// VRAM / CRAM base addresses (set by 6502 via commands, 0 = not set).
+// Written under captureLock: SET_VRAM/SET_CRAM, FLIP at the boundary
 static uint16_t vramBase = 0;
 static uint16_t cramBase = 0;
 
+// Character RAM (SET_CHARRAM): 256 guest-defined glyphs, 0 = built-in font
+static uint16_t charRamBase = 0;
+
+// Page flip (FLIP): bases that replace vramBase/cramBase at the next frame
+// boundary, under captureLock so no capture sees one without the other
+static uint16_t flipVram = 0;
+static uint16_t flipCram = 0;
+static int      flipPending = 0;
+
 // Cursor
 static uint8_t cursorCol    = 0;
 static uint8_t cursorRow    = 0;
 static int     cursorOn     = 0;
 
+// Hardware scroll: buffer row shown on screen row 0 (see dispgfx.h).
+// Written under captureLock, together with the rows it recycles
+static uint8_t scrollRow    = 0;
+
+// Text geometry selected by SET_MODE (worker thread; changed under
+// captureLock so a live capture never sees half of a switch)
+static int     textCols     = DISPGFX_COLS;
+static int     textRows     = DISPGFX_ROWS;
+
 // Border colour index
 static uint8_t borderColour = 0; // black
 
+// DISPGFX_IRQ_* sources enabled by SET_IRQ
+static volatile _Atomic uint8_t irqEnable = 0;
+
+// Bitmap mode (see dispgfx.h). bitmapLock keeps the render thread from
+// snapshotting between a blitter command's window flush and reload.
+// displayMode is written under captureLock in every mode switch.
+static int      displayMode = DISPGFX_MODE_TEXT;
+static uint8_t  bitmap[DISPGFX_BITMAP_SIZE];
+static uint16_t windowBase  = 0;   // guest address of the bank window, 0 = none
+static uint8_t  windowBank  = 0;
+static pthread_mutex_t bitmapLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Captured frames (double buffer). The renderer rasterizes frames[front]
+// only, never guest memory. Without PRESENT the render thread captures a
+// frame itself each tick (copy, then re-check, retrying while the CPU is
+// mid-write); after the guest's first PRESENT the worker captures at
+// PRESENT while the CPU waits, and the renderer just shows the latest one.
+// frameLock is held while the renderer reads the front frame and while the
+// front index flips, so a capture never overwrites a frame being drawn.
+static dispgfx_frame_t frames[2];
+static volatile _Atomic int frontFrame   = 0;
+static volatile _Atomic int presentMode  = 0;  // 1 after the first PRESENT
+static pthread_mutex_t frameLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t captureLock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t captureRetries = 0;            // torn live copies redone
+
+// Frame consumers that opened (--record-video, --shm)
+static int recording = 0;
+static int exporting = 0;
+
+// Dirty tracking (render thread only). The shadows hold the character and
+// attribute each cell of framebuf was last drawn with; a frame re-rasterizes
+// only cells whose VRAM/CRAM bytes differ, plus the cursor cell when it
+// moves or blinks, and uploads only the band of character rows it touched.
+static uint8_t shadowVram[DISPGFX_VRAM_MAX];
+static uint8_t shadowCram[DISPGFX_VRAM_MAX];
+static int     shadowValid   = 0;   // 0 = redraw every cell next frame
+static int     fbBlank       = 0;   // framebuf cleared for "no VRAM set"
+static int     cursorDrawn   = -1;  // cell index drawn inverted, -1 = none
+static int     dirtyRowMin   = 0;   // rows rewritten by the last render,
+static int     dirtyRowMax   = -1;  // empty when max < min
+static int     shadowMode    = -1;  // mode the shadows belong to
+static uint8_t shadowBitmap[DISPGFX_BITMAP_SIZE];
+
+// Glyph dirty bits (render thread only). shadowFont holds the character
+// RAM the cells in framebuf were drawn with; each frame compares it glyph
+// by glyph, and a cell is redrawn when its glyph changed even if its
+// VRAM/CRAM bytes did not.
+static uint8_t shadowFont[DISPGFX_GLYPHS][DISPGFX_CHAR_H];
+static int     shadowCharRam = 0;   // shadows drawn from character RAM
+static uint8_t glyphDirty[DISPGFX_GLYPHS];
+static int     anyGlyphDirty = 0;
+
+// Finished frames (triple buffer). The raster thread fills slots[back] and
+// swaps it with `ready`; the main thread swaps `ready` with `front` and
+// uploads from front. Neither side ever waits for the other: if the raster
+// thread finishes again before the main thread took the last frame, that
+// frame is dropped and its dirty rows carry over to the new one.
+typedef struct {
+    uint32_t px[DISPGFX_MAX_WIDTH * DISPGFX_MAX_HEIGHT];
+    int      width, height;                 // pixels in use, width = pitch
+    int      rowMin, rowMax;                // character rows changed
+} dispgfx_slot_t;
+
+static dispgfx_slot_t slots[3];
+static int      slotFront = 0, slotReady = 1, slotBack = 2;
+static int      slotFresh = 0;              // ready not yet taken by main
+static pthread_mutex_t slotLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t frameEvent  = 0;            // SDL user event: frame ready
+static int      needPresent = 0;            // main thread only
+static int      texWidth  = DISPGFX_WIDTH;  // sdlTexture size (main thread)
+static int      texHeight = DISPGFX_HEIGHT;
+
+// Per-frame cost of rasterizing (raster thread) and what the main thread
+// did with the frames, printed by dispgfxCleanup()
+static struct {
+    uint64_t frames;
+    uint64_t cells;         // cells re-rasterized
+    uint64_t rows;          // character rows uploaded
+    uint64_t presents;
+    uint64_t dropped;       // finished but replaced before being shown
+    uint64_t glyphs;        // character-RAM glyphs that changed
+    double   totalUs;
+    double   maxUs;
+} renderStats;
+
 // Keyboard data-register address (read from device table for forwarding)
 static uint16_t kbdDataRegAddr_local = 0;
 
@@ -217,23 +344,7 @@ static const uint8_t font8x8[128][8] = {
 
 // ─── Initialisation (called from main thread) ───────────────────────────────
 
-void dispgfxInit(void) {
-    // Read device-table entries for this device
-    dispgfxCmdRegAddr =
-        (uint16_t)read6502(EMU_DISPGFX_BASE) |
-        ((uint16_t)read6502(EMU_DISPGFX_BASE + 1) << 8);
-    dispgfxDataRegAddr =
-        (uint16_t)read6502(EMU_DISPGFX_BASE + 2) |
-        ((uint16_t)read6502(EMU_DISPGFX_BASE + 3) << 8);
-    dispgfxStatusRegAddr =
-        (uint16_t)read6502(EMU_DISPGFX_BASE + 4) |
-        ((uint16_t)read6502(EMU_DISPGFX_BASE + 5) << 8);
-
-    // Also snag the kbd register address so we can forward SDL key events
-    kbdDataRegAddr_local =
-        (uint16_t)read6502(EMU_KBD_DATA_REG) |
-        ((uint16_t)read6502(EMU_KBD_DATA_REG + 1) << 8);
-
+static void dispgfxInitSdl(void) {
     // ── SDL init (must be on main thread for macOS) ──────────────────────────
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         fprintf(stderr, "[DISPGFX] SDL_Init failed: %s\n", SDL_GetError());
@@ -253,9 +364,11 @@ void dispgfxInit(void) {
         exit(1);
     }
 
+    // No PRESENTVSYNC: a present blocked on vsync would hold up the event
+    // pump. Presents are paced by the raster thread's 60 Hz frames instead.
     sdlRenderer = SDL_CreateRenderer(
         sdlWindow, -1,
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        SDL_RENDERER_ACCELERATED);
     if (!sdlRenderer) {
         // Fall back to software renderer
         sdlRenderer = SDL_CreateRenderer(sdlWindow, -1, SDL_RENDERER_SOFTWARE);
@@ -284,6 +397,31 @@ void dispgfxInit(void) {
         SDL_Quit();
         exit(1);
     }
+}
+
+void dispgfxInit(void) {
+    // Read device-table entries for this device
+    dispgfxCmdRegAddr =
+        (uint16_t)read6502(EMU_DISPGFX_BASE) |
+        ((uint16_t)read6502(EMU_DISPGFX_BASE + 1) << 8);
+    dispgfxDataRegAddr =
+        (uint16_t)read6502(EMU_DISPGFX_BASE + 2) |
+        ((uint16_t)read6502(EMU_DISPGFX_BASE + 3) << 8);
+    dispgfxStatusRegAddr =
+        (uint16_t)read6502(EMU_DISPGFX_BASE + 4) |
+        ((uint16_t)read6502(EMU_DISPGFX_BASE + 5) << 8);
+
+    // Also snag the kbd register address so we can forward SDL key events
+    kbdDataRegAddr_local =
+        (uint16_t)read6502(EMU_KBD_DATA_REG) |
+        ((uint16_t)read6502(EMU_KBD_DATA_REG + 1) << 8);
+
+    // Reports before curses starts
+    if (dispgfxShmName) exporting = dispshmOpen(dispgfxShmName, palette) == 0;
+    if (dispgfxTui) disptuiInit(font8x8);
+    else if (!dispgfxHeadless) dispgfxInitSdl();
+    if (dispgfxRecordFile)
+        recording = dispvidOpen(dispgfxRecordFile, palette, font8x8) == 0;
 
     // Mark device idle
     if (dispgfxStatusRegAddr) {
@@ -292,14 +430,402 @@ void dispgfxInit(void) {
 
     // Clear framebuffer to black
     memset(framebuf, 0, sizeof(framebuf));
+    glyphInit();
 
     // Spawn the command-processing worker (same pattern as other devices)
     pthread_create(&workerThread, NULL, &dispgfxWorker, NULL);
     pthread_detach(workerThread);
 
-    fprintf(stderr, "[DISPGFX] 40x30 text display ready  (%dx%d window)\n",
+    if (dispgfxTui) return; // curses owns the terminal from here on
+    if (dispgfxHeadless) {
+        fprintf(stderr, "[DISPGFX] headless (%s glyphs, dump %s)\n",
+                glyphImplName, dispgfxDumpFile ? dispgfxDumpFile : "off");
+        return;
+    }
+    fprintf(stderr,
+            "[DISPGFX] 40x30/80x25/80x50 text, 320x240 bitmap display ready  "
+            "(%dx%d window, %s glyphs)\n",
             DISPGFX_WIDTH * DISPGFX_SCALE,
-            DISPGFX_HEIGHT * DISPGFX_SCALE);
+            DISPGFX_HEIGHT * DISPGFX_SCALE, glyphImplName);
+}
+
+// ─── Text-buffer helpers (worker thread) ─────────────────────────────────────
+
+// Address of screen cell (row, col) in the buffer at `base`
+static uint16_t dispgfxCellAddr(uint16_t base, int row, int col) {
+    int bufRow = (scrollRow + row) % textRows;
+    return (uint16_t)(base + bufRow * textCols + col);
+}
+
+static void dispgfxBlankRow(int row, uint8_t attr) {
+    for (int col = 0; col < textCols; col++) {
+        if (vramBase) mem6502[dispgfxCellAddr(vramBase, row, col)] = 0x20;
+        if (cramBase) mem6502[dispgfxCellAddr(cramBase, row, col)] = attr;
+    }
+}
+
+// The ring moves and the recycled rows are blanked under one captureLock
+// hold: a capture in between would show the new start over stale rows,
+// and the verify pass can't see that since memory doesn't change under it.
+static void dispgfxScroll(int rows, int up, uint8_t attr) {
+    if (rows > textRows) rows = textRows;
+    pthread_mutex_lock(&captureLock);
+    if (up) {
+        scrollRow = (uint8_t)((scrollRow + rows) % textRows);
+        for (int r = textRows - rows; r < textRows; r++)
+            dispgfxBlankRow(r, attr);
+    } else {
+        scrollRow = (uint8_t)((scrollRow + textRows - rows) % textRows);
+        for (int r = 0; r < rows; r++)
+            dispgfxBlankRow(r, attr);
+    }
+    pthread_mutex_unlock(&captureLock);
+}
+
+// Clip a rectangle to the screen; returns 0 if nothing is left
+static int dispgfxClip(int *col, int *row, int *w, int *h) {
+    if (*col >= textCols || *row >= textRows) return 0;
+    if (*col + *w > textCols) *w = textCols - *col;
+    if (*row + *h > textRows) *h = textRows - *row;
+    return *w > 0 && *h > 0;
+}
+
+static void dispgfxFillRect(uint16_t blk) {
+    uint8_t planes = mem6502[blk];
+    int col = mem6502[(uint16_t)(blk + 1)], row = mem6502[(uint16_t)(blk + 2)];
+    int w = mem6502[(uint16_t)(blk + 3)], h = mem6502[(uint16_t)(blk + 4)];
+    uint8_t ch = mem6502[(uint16_t)(blk + 5)];
+    uint8_t attr = mem6502[(uint16_t)(blk + 6)];
+    if (!dispgfxClip(&col, &row, &w, &h)) return;
+
+    for (int r = row; r < row + h; r++) {
+        for (int c = col; c < col + w; c++) {
+            if ((planes & DISPGFX_PLANE_VRAM) && vramBase)
+                mem6502[dispgfxCellAddr(vramBase, r, c)] = ch;
+            if ((planes & DISPGFX_PLANE_CRAM) && cramBase)
+                mem6502[dispgfxCellAddr(cramBase, r, c)] = attr;
+        }
+    }
+}
+
+static void dispgfxCopyPlane(uint16_t base, int sc, int sr, int dc, int dr,
+                             int w, int h) {
+    // Through a temporary, so overlapping source and destination are safe
+    uint8_t tmp[DISPGFX_VRAM_MAX];
+    for (int r = 0; r < h; r++)
+        for (int c = 0; c < w; c++)
+            tmp[r * w + c] = mem6502[dispgfxCellAddr(base, sr + r, sc + c)];
+    for (int r = 0; r < h; r++)
+        for (int c = 0; c < w; c++)
+            mem6502[dispgfxCellAddr(base, dr + r, dc + c)] = tmp[r * w + c];
+}
+
+static void dispgfxCopyRect(uint16_t blk) {
+    uint8_t planes = mem6502[blk];
+    int sc = mem6502[(uint16_t)(blk + 1)], sr = mem6502[(uint16_t)(blk + 2)];
+    int dc = mem6502[(uint16_t)(blk + 3)], dr = mem6502[(uint16_t)(blk + 4)];
+    int w = mem6502[(uint16_t)(blk + 5)], h = mem6502[(uint16_t)(blk + 6)];
+    // Clip against both rectangles
+    if (!dispgfxClip(&sc, &sr, &w, &h) || !dispgfxClip(&dc, &dr, &w, &h))
+        return;
+
+    if ((planes & DISPGFX_PLANE_VRAM) && vramBase)
+        dispgfxCopyPlane(vramBase, sc, sr, dc, dr, w, h);
+    if ((planes & DISPGFX_PLANE_CRAM) && cramBase)
+        dispgfxCopyPlane(cramBase, sc, sr, dc, dr, w, h);
+}
+
+// ─── Bitmap helpers and blitter (worker thread) ──────────────────────────────
+
+static uint16_t dispgfxBlockWord(uint16_t blk, int off) {
+    return (uint16_t)mem6502[(uint16_t)(blk + off)] |
+           ((uint16_t)mem6502[(uint16_t)(blk + off + 1)] << 8);
+}
+
+static uint32_t dispgfxBankLen(int bank) {
+    uint32_t off = (uint32_t)bank * DISPGFX_BANK_SIZE;
+    uint32_t left = DISPGFX_BITMAP_SIZE - off;
+    return left < DISPGFX_BANK_SIZE ? left : DISPGFX_BANK_SIZE;
+}
+
+// Window → bitmap: the guest's view of the mapped bank is authoritative
+static void dispgfxWindowFlush(void) {
+    if (windowBase)
+        dma6502Read(windowBase, &bitmap[windowBank * DISPGFX_BANK_SIZE],
+                    dispgfxBankLen(windowBank));
+}
+
+static void dispgfxWindowLoad(void) {
+    if (windowBase)
+        dma6502Write(windowBase, &bitmap[windowBank * DISPGFX_BANK_SIZE],
+                     dispgfxBankLen(windowBank));
+}
+
+static uint8_t dispgfxGetPixel(int x, int y) {
+    uint8_t b = bitmap[y * DISPGFX_BITMAP_PITCH + x / 2];
+    return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+static void dispgfxPutPixel(int x, int y, uint8_t c) {
+    if (x < 0 || y < 0 || x >= DISPGFX_WIDTH || y >= DISPGFX_HEIGHT) return;
+    uint8_t *b = &bitmap[y * DISPGFX_BITMAP_PITCH + x / 2];
+    *b = (x & 1) ? (uint8_t)((*b & 0xF0) | c) : (uint8_t)((*b & 0x0F) | (c << 4));
+}
+
+// Clip x/y/w/h to the bitmap; returns 0 if nothing is left
+static int dispgfxClipPixels(int *x, int *y, int *w, int *h) {
+    if (*x < 0) { *w += *x; *x = 0; }
+    if (*y < 0) { *h += *y; *y = 0; }
+    if (*x + *w > DISPGFX_WIDTH)  *w = DISPGFX_WIDTH - *x;
+    if (*y + *h > DISPGFX_HEIGHT) *h = DISPGFX_HEIGHT - *y;
+    return *w > 0 && *h > 0;
+}
+
+static void dispgfxDrawLine(uint16_t blk) {
+    int x0 = dispgfxBlockWord(blk, 0), y0 = mem6502[(uint16_t)(blk + 2)];
+    int x1 = dispgfxBlockWord(blk, 3), y1 = mem6502[(uint16_t)(blk + 5)];
+    uint8_t c = mem6502[(uint16_t)(blk + 6)] & 0x0F;
+
+    // Bresenham, all octants; off-screen pixels are dropped
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1, sx = x0 < x1 ? 1 : -1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0, sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        dispgfxPutPixel(x0, y0, c);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+static void dispgfxBlitFill(uint16_t blk) {
+    int x = dispgfxBlockWord(blk, 0), y = mem6502[(uint16_t)(blk + 2)];
+    int w = dispgfxBlockWord(blk, 3), h = mem6502[(uint16_t)(blk + 5)];
+    uint8_t c = mem6502[(uint16_t)(blk + 6)] & 0x0F;
+    if (!dispgfxClipPixels(&x, &y, &w, &h)) return;
+
+    for (int r = y; r < y + h; r++) {
+        int left = x, right = x + w;      // [left, right)
+        if (left & 1) dispgfxPutPixel(left++, r, c);
+        if ((right & 1) && right > left) dispgfxPutPixel(--right, r, c);
+        if (right > left)                 // whole bytes in between
+            memset(&bitmap[r * DISPGFX_BITMAP_PITCH + left / 2],
+                   (c << 4) | c, (size_t)(right - left) / 2);
+    }
+}
+
+static void dispgfxBlitCopy(uint16_t blk) {
+    static uint8_t tmp[DISPGFX_WIDTH * DISPGFX_HEIGHT];
+    int sx = dispgfxBlockWord(blk, 0), sy = mem6502[(uint16_t)(blk + 2)];
+    int dx = dispgfxBlockWord(blk, 3), dy = mem6502[(uint16_t)(blk + 5)];
+    int w = dispgfxBlockWord(blk, 6), h = mem6502[(uint16_t)(blk + 8)];
+    // Clip against both rectangles
+    if (!dispgfxClipPixels(&sx, &sy, &w, &h) ||
+        !dispgfxClipPixels(&dx, &dy, &w, &h))
+        return;
+
+    // Through a temporary, so overlapping source and destination are safe
+    for (int r = 0; r < h; r++)
+        for (int c = 0; c < w; c++)
+            tmp[r * w + c] = dispgfxGetPixel(sx + c, sy + r);
+    for (int r = 0; r < h; r++)
+        for (int c = 0; c < w; c++)
+            dispgfxPutPixel(dx + c, dy + r, tmp[r * w + c]);
+}
+
+static void dispgfxBlitImage(uint16_t blk) {
+    uint16_t src = dispgfxBlockWord(blk, 0);
+    int dx = dispgfxBlockWord(blk, 2), dy = mem6502[(uint16_t)(blk + 4)];
+    int w = dispgfxBlockWord(blk, 5), h = mem6502[(uint16_t)(blk + 7)];
+    uint8_t key = mem6502[(uint16_t)(blk + 8)];
+    int pitch = (w + 1) / 2;
+
+    for (int r = 0; r < h && dy + r < DISPGFX_HEIGHT; r++) {
+        for (int c = 0; c < w && dx + c < DISPGFX_WIDTH; c++) {
+            uint8_t b = mem6502[(uint16_t)(src + r * pitch + c / 2)];
+            uint8_t p = (c & 1) ? (b & 0x0F) : (b >> 4);
+            if (p != key) dispgfxPutPixel(dx + c, dy + r, p);
+        }
+    }
+}
+
+// Run one blitter command against the whole bitmap, window included
+static void dispgfxBlit(uint8_t cmd, uint16_t blk) {
+    pthread_mutex_lock(&bitmapLock);
+    dispgfxWindowFlush();
+    switch (cmd) {
+    case DISPGFX_CMD_DRAW_LINE:  dispgfxDrawLine(blk);  break;
+    case DISPGFX_CMD_BLIT_FILL:  dispgfxBlitFill(blk);  break;
+    case DISPGFX_CMD_BLIT_COPY:  dispgfxBlitCopy(blk);  break;
+    case DISPGFX_CMD_BLIT_IMAGE: dispgfxBlitImage(blk); break;
+    default: break;
+    }
+    dispgfxWindowLoad();
+    pthread_mutex_unlock(&bitmapLock);
+}
+
+// ─── Frame capture ───────────────────────────────────────────────────────────
+
+static void dispgfxCopyGuest(uint8_t *dst, uint16_t addr, int len) {
+    if ((uint32_t)addr + (uint32_t)len <= 0x10000u) {
+        memcpy(dst, &mem6502[addr], (size_t)len);
+    } else {
+        for (int i = 0; i < len; i++) dst[i] = mem6502[(addr + i) & 0xFFFF];
+    }
+}
+
+static int dispgfxSameGuest(const uint8_t *src, uint16_t addr, int len) {
+    if ((uint32_t)addr + (uint32_t)len <= 0x10000u)
+        return memcmp(src, &mem6502[addr], (size_t)len) == 0;
+    for (int i = 0; i < len; i++)
+        if (src[i] != mem6502[(addr + i) & 0xFFFF]) return 0;
+    return 1;
+}
+
+// Copy the guest-visible state into `f`. With `verify`, each guest range is
+// compared again after the copy and recopied (up to 3 times) if the CPU
+// wrote it meanwhile, so a live capture never mixes two updates of a row.
+static void dispgfxCapture(dispgfx_frame_t *f, int verify) {
+    f->mode = displayMode;
+    if (f->mode == DISPGFX_MODE_BITMAP) {
+        pthread_mutex_lock(&bitmapLock);
+        memcpy(f->bitmap, bitmap, sizeof(f->bitmap));
+        if (windowBase) {
+            uint8_t *win = &f->bitmap[windowBank * DISPGFX_BANK_SIZE];
+            int len = (int)dispgfxBankLen(windowBank);
+            for (int t = 0; t < 3; t++) {
+                dispgfxCopyGuest(win, windowBase, len);
+                if (!verify || dispgfxSameGuest(win, windowBase, len)) break;
+                captureRetries++;
+            }
+        }
+        pthread_mutex_unlock(&bitmapLock);
+        return;
+    }
+
+    uint16_t vb = vramBase, cb = cramBase;
+    uint8_t start = scrollRow;
+    int cols = textCols, rows = textRows;
+    f->cols = cols;
+    f->rows = rows;
+    f->scroll = start;
+    uint16_t fb = charRamBase;
+    f->hasVram = vb != 0;
+    if (!vb) return;
+
+    // Glyphs first: a cell is only ever newer than the glyph it shows
+    f->hasCharRam = fb != 0;
+    if (fb) {
+        for (int t = 0; t < 3; t++) {
+            dispgfxCopyGuest(&f->charRam[0][0], fb, (int)sizeof(f->charRam));
+            if (!verify ||
+                dispgfxSameGuest(&f->charRam[0][0], fb, (int)sizeof(f->charRam)))
+                break;
+            captureRetries++;
+        }
+    }
+
+    // Ring order: buffer rows start..rows-1 then 0..start-1, two copies each
+    int first = (rows - start) * cols;
+    int second = start * cols;
+    uint16_t vStart = (uint16_t)(vb + start * cols);
+    uint16_t cStart = (uint16_t)(cb + start * cols);
+    for (int t = 0; t < 3; t++) {
+        dispgfxCopyGuest(f->vram, vStart, first);
+        dispgfxCopyGuest(f->vram + first, vb, second);
+        if (cb) {
+            dispgfxCopyGuest(f->cram, cStart, first);
+            dispgfxCopyGuest(f->cram + first, cb, second);
+        } else {
+            memset(f->cram, 0x07, (size_t)(cols * rows)); // light grey on black
+        }
+        if (!verify ||
+            (dispgfxSameGuest(f->vram, vStart, first) &&
+             dispgfxSameGuest(f->vram + first, vb, second) &&
+             (!cb || (dispgfxSameGuest(f->cram, cStart, first) &&
+                      dispgfxSameGuest(f->cram + first, cb, second)))))
+            break;
+        captureRetries++;
+    }
+}
+
+// Capture into the back buffer and make it the front one. captureLock
+// covers the first PRESENT racing a live capture on the render thread.
+static void dispgfxPublish(int verify) {
+    pthread_mutex_lock(&captureLock);
+    int back = 1 - frontFrame;
+    dispgfxCapture(&frames[back], verify);
+    pthread_mutex_lock(&frameLock);
+    frontFrame = back;
+    pthread_mutex_unlock(&frameLock);
+    pthread_mutex_unlock(&captureLock);
+}
+
+// ─── Mode switch ─────────────────────────────────────────────────────────────
+
+// Text modes also set the geometry: the ring restarts at row 0 and the
+// cursor goes home. Bitmap mode keeps the text geometry for GET_GEOMETRY.
+static void dispgfxSetMode(uint8_t mode) {
+    int cols, rows;
+    switch (mode) {
+    case DISPGFX_MODE_TEXT:      cols = 40; rows = 30; break;
+    case DISPGFX_MODE_TEXT80X25: cols = 80; rows = 25; break;
+    case DISPGFX_MODE_TEXT80X50: cols = 80; rows = 50; break;
+    case DISPGFX_MODE_BITMAP:
+        pthread_mutex_lock(&captureLock);
+        displayMode = mode;
+        pthread_mutex_unlock(&captureLock);
+        return;
+    default:
+        return;
+    }
+    pthread_mutex_lock(&captureLock);
+    textCols = cols;
+    textRows = rows;
+    scrollRow = 0;
+    cursorCol = 0;
+    cursorRow = 0;
+    displayMode = mode;
+    pthread_mutex_unlock(&captureLock);
+}
+
+// ─── Status register ─────────────────────────────────────────────────────────
+// The worker (IDLE/BUSY) and the render loop (VBLANK) share the register,
+// so every update is a read-modify-write under dispgfxLock.
+
+static void dispgfxSetStatus(uint8_t set, uint8_t clear) {
+    if (!dispgfxStatusRegAddr) return;
+    pthread_mutex_lock(&dispgfxLock);
+    mem6502[dispgfxStatusRegAddr] =
+        (uint8_t)((mem6502[dispgfxStatusRegAddr] & ~clear) | set);
+    pthread_mutex_unlock(&dispgfxLock);
+}
+
+uint8_t dispgfxStatusRead(void) {
+    uint8_t v = mem6502[dispgfxStatusRegAddr];
+    mem6502[dispgfxStatusRegAddr] = v & (uint8_t)~DISPGFX_STATUS_VBLANK;
+    return v;
+}
+
+// ─── Page flip ───────────────────────────────────────────────────────────────
+
+// Frame boundary: apply a pending FLIP. With PRESENT in use the flipped
+// page is captured right away (verified: the CPU may be running), since
+// nothing else would show it.
+static void dispgfxFrameBoundary(void) {
+    pthread_mutex_lock(&captureLock);
+    int flipped = flipPending;
+    if (flipped) {
+        vramBase = flipVram;
+        cramBase = flipCram;
+        flipPending = 0;
+    }
+    pthread_mutex_unlock(&captureLock);
+
+    if (!flipped) return;
+    if (presentMode) dispgfxPublish(1);
+    dispgfxSetStatus(0, DISPGFX_STATUS_FLIP);
 }
 
 // ─── Command-processing worker thread ────────────────────────────────────────
@@ -318,45 +844,58 @@ void *dispgfxWorker(void *args) {
 
         if (!running) break;
 
-        uint8_t st = read6502(dispgfxStatusRegAddr);
         uint8_t cmd = read6502(dispgfxCmdRegAddr);
 
         // Mark busy
-        st &= ~DISPGFX_STATUS_IDLE;
-        st |= DISPGFX_STATUS_BUSY;
-        write6502(dispgfxStatusRegAddr, st);
+        dispgfxSetStatus(DISPGFX_STATUS_BUSY, DISPGFX_STATUS_IDLE);
 
         switch (cmd) {
 
-        case DISPGFX_CMD_SET_VRAM: {
-            vramBase = (uint16_t)read6502(dispgfxDataRegAddr) |
-                       ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
-            break;
-        }
-
+        case DISPGFX_CMD_SET_VRAM:
         case DISPGFX_CMD_SET_CRAM: {
-            cramBase = (uint16_t)read6502(dispgfxDataRegAddr) |
-                       ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            // The latest base wins: a FLIP still waiting for the frame
+            // boundary is dropped rather than applied over this one
+            uint16_t base = (uint16_t)read6502(dispgfxDataRegAddr) |
+                            ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            pthread_mutex_lock(&captureLock);
+            if (cmd == DISPGFX_CMD_SET_VRAM)
+                vramBase = base;
+            else
+                cramBase = base;
+            int cancelled = flipPending;
+            flipPending = 0;
+            pthread_mutex_unlock(&captureLock);
+            if (cancelled) dispgfxSetStatus(0, DISPGFX_STATUS_FLIP);
             break;
         }
 
         case DISPGFX_CMD_CLEAR: {
+            if (displayMode == DISPGFX_MODE_BITMAP) {
+                pthread_mutex_lock(&bitmapLock);
+                memset(bitmap, 0, sizeof(bitmap));
+                dispgfxWindowLoad();
+                pthread_mutex_unlock(&bitmapLock);
+                break;
+            }
+            pthread_mutex_lock(&captureLock);
+            scrollRow = 0;
             if (vramBase) {
-                for (int i = 0; i < DISPGFX_VRAM_SIZE; i++)
+                for (int i = 0; i < textCols * textRows; i++)
                     mem6502[(vramBase + i) & 0xFFFF] = 0x20; // space
             }
             if (cramBase) {
-                for (int i = 0; i < DISPGFX_VRAM_SIZE; i++)
+                for (int i = 0; i < textCols * textRows; i++)
                     mem6502[(cramBase + i) & 0xFFFF] = 0x07; // light grey on black
             }
+            pthread_mutex_unlock(&captureLock);
             break;
         }
 
         case DISPGFX_CMD_SET_CURSOR: {
             cursorCol = read6502(dispgfxDataRegAddr);
             cursorRow = read6502(dispgfxDataRegAddr + 1);
-            if (cursorCol >= DISPGFX_COLS) cursorCol = DISPGFX_COLS - 1;
-            if (cursorRow >= DISPGFX_ROWS) cursorRow = DISPGFX_ROWS - 1;
+            if (cursorCol >= textCols) cursorCol = (uint8_t)(textCols - 1);
+            if (cursorRow >= textRows) cursorRow = (uint8_t)(textRows - 1);
             break;
         }
 
@@ -373,15 +912,95 @@ void *dispgfxWorker(void *args) {
             break;
         }
 
+        case DISPGFX_CMD_SCROLL_UP:
+        case DISPGFX_CMD_SCROLL_DOWN: {
+            dispgfxScroll(read6502(dispgfxDataRegAddr),
+                          cmd == DISPGFX_CMD_SCROLL_UP,
+                          read6502(dispgfxDataRegAddr + 1));
+            break;
+        }
+
+        case DISPGFX_CMD_FILL_RECT:
+        case DISPGFX_CMD_COPY_RECT: {
+            uint16_t blk = (uint16_t)read6502(dispgfxDataRegAddr) |
+                           ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            if (cmd == DISPGFX_CMD_FILL_RECT)
+                dispgfxFillRect(blk);
+            else
+                dispgfxCopyRect(blk);
+            break;
+        }
+
+        case DISPGFX_CMD_SET_MODE:
+            dispgfxSetMode(read6502(dispgfxDataRegAddr));
+            write6502(dispgfxDataRegAddr, (uint8_t)textCols);
+            write6502(dispgfxDataRegAddr + 1, (uint8_t)textRows);
+            break;
+
+        case DISPGFX_CMD_SET_CHARRAM: {
+            charRamBase = (uint16_t)read6502(dispgfxDataRegAddr) |
+                          ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            break;
+        }
+
+        case DISPGFX_CMD_FLIP: {
+            uint16_t blk = (uint16_t)read6502(dispgfxDataRegAddr) |
+                           ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            dispgfxSetStatus(DISPGFX_STATUS_FLIP, 0);
+            pthread_mutex_lock(&captureLock);
+            flipVram = dispgfxBlockWord(blk, 0);
+            flipCram = dispgfxBlockWord(blk, 2);
+            flipPending = 1;
+            pthread_mutex_unlock(&captureLock);
+            break;
+        }
+
+        case DISPGFX_CMD_GET_GEOMETRY:
+            write6502(dispgfxDataRegAddr, (uint8_t)textCols);
+            write6502(dispgfxDataRegAddr + 1, (uint8_t)textRows);
+            break;
+
+        case DISPGFX_CMD_SET_WINDOW:
+        case DISPGFX_CMD_SET_BANK: {
+            pthread_mutex_lock(&bitmapLock);
+            dispgfxWindowFlush();
+            if (cmd == DISPGFX_CMD_SET_WINDOW) {
+                windowBase = (uint16_t)read6502(dispgfxDataRegAddr) |
+                             ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8);
+            } else {
+                uint8_t bank = read6502(dispgfxDataRegAddr);
+                if (bank < DISPGFX_BANKS) windowBank = bank;
+            }
+            dispgfxWindowLoad();
+            pthread_mutex_unlock(&bitmapLock);
+            break;
+        }
+
+        case DISPGFX_CMD_PRESENT:
+            // The CPU is waiting for IDLE, so VRAM is not changing
+            presentMode = 1;
+            dispgfxPublish(0);
+            break;
+
+        case DISPGFX_CMD_SET_IRQ:
+            irqEnable = read6502(dispgfxDataRegAddr) & DISPGFX_IRQ_VBLANK;
+            break;
+
+        case DISPGFX_CMD_DRAW_LINE:
+        case DISPGFX_CMD_BLIT_FILL:
+        case DISPGFX_CMD_BLIT_COPY:
+        case DISPGFX_CMD_BLIT_IMAGE:
+            dispgfxBlit(cmd, (uint16_t)read6502(dispgfxDataRegAddr) |
+                             ((uint16_t)read6502(dispgfxDataRegAddr + 1) << 8));
+            break;
+
         default:
             break;
         }
 
         // Clear command, mark idle
         write6502(dispgfxCmdRegAddr, DISPGFX_CMD_NOP);
-        st &= ~DISPGFX_STATUS_BUSY;
-        st |= DISPGFX_STATUS_IDLE;
-        write6502(dispgfxStatusRegAddr, st);
+        dispgfxSetStatus(DISPGFX_STATUS_IDLE, DISPGFX_STATUS_BUSY);
     }
 
     return NULL;
@@ -396,150 +1015,461 @@ static void dispgfxForwardKey(uint8_t k) {
     mem6502[kbdDataRegAddr_local] = k;
     pthread_mutex_unlock(&kbdLock);
 
-    irqPending = 1;
+    irqcRaise(IRQC_SRC_KBD);
 }
 
 // ─── Rendering (produces one frame into framebuf[]) ──────────────────────────
 
-static void dispgfxRender(void) {
+static void dispgfxDrawCell(int row, int col, const uint8_t *glyph,
+                            uint8_t attr, int inverted) {
+    uint32_t fg = palette[attr & 0x0F];
+    uint32_t bg = palette[(attr >> 4) & 0x0F];
+
+    // Invert colours at cursor position
+    if (inverted) {
+        uint32_t tmp = fg;
+        fg = bg;
+        bg = tmp;
+    }
+
+    // Blit the 8×8 glyph
+    glyphDraw(&framebuf[row * DISPGFX_CHAR_H * fbWidth +
+                        col * DISPGFX_CHAR_W],
+              fbWidth, glyph, fg, bg);
+}
+
+static void dispgfxMarkRow(int row) {
+    if (row < dirtyRowMin) dirtyRowMin = row;
+    if (row > dirtyRowMax) dirtyRowMax = row;
+}
+
+// Bitmap mode: convert the character-row bands (8 pixel rows) that changed
+static void dispgfxRenderBitmap(const dispgfx_frame_t *f) {
+    const int band = DISPGFX_CHAR_H * DISPGFX_BITMAP_PITCH;
+
+    for (int row = 0; row < DISPGFX_ROWS; row++) {
+        const uint8_t *src = &f->bitmap[row * band];
+        if (shadowValid && memcmp(src, &shadowBitmap[row * band], band) == 0)
+            continue;
+
+        uint32_t *dst = &framebuf[row * DISPGFX_CHAR_H * DISPGFX_WIDTH];
+        for (int i = 0; i < band; i++) {
+            dst[2 * i]     = palette[src[i] >> 4];
+            dst[2 * i + 1] = palette[src[i] & 0x0F];
+        }
+        memcpy(&shadowBitmap[row * band], src, band);
+        renderStats.cells += DISPGFX_COLS;
+        dispgfxMarkRow(row);
+    }
+    shadowValid = 1;
+}
+
+// Text mode: re-rasterize the cells that changed. `cols` and `rows` are
+// compile-time constants at every call site (see dispgfxRenderFrame), so
+// each geometry gets its own loops and the cost stays linear in cells.
+static inline void dispgfxRenderText(const dispgfx_frame_t *f, int cols,
+                                     int rows, int cursorIdx) {
+    int cursorOld = cursorDrawn;
+    int cursorMoved = cursorIdx != cursorOld;
+
+    for (int row = 0; row < rows; row++) {
+        int base = row * cols;
+        const uint8_t *chars = &f->vram[base], *attrs = &f->cram[base];
+
+        int forced = cursorMoved &&
+                     ((cursorIdx >= 0 && cursorIdx / cols == row) ||
+                      (cursorOld >= 0 && cursorOld / cols == row));
+        for (int col = 0; anyGlyphDirty && !forced && col < cols; col++)
+            forced = glyphDirty[chars[col]];
+        if (shadowValid && !forced &&
+            memcmp(chars, &shadowVram[base], (size_t)cols) == 0 &&
+            memcmp(attrs, &shadowCram[base], (size_t)cols) == 0) {
+            continue;
+        }
+
+        for (int col = 0; col < cols; col++) {
+            int idx = base + col;
+            if (shadowValid && chars[col] == shadowVram[idx] &&
+                attrs[col] == shadowCram[idx] && !glyphDirty[chars[col]] &&
+                !(cursorMoved && (idx == cursorIdx || idx == cursorOld))) {
+                continue;
+            }
+            // Built-in font: characters 128-255 show glyph 0 (blank)
+            const uint8_t *glyph =
+                f->hasCharRam ? f->charRam[chars[col]]
+                              : font8x8[chars[col] < 128 ? chars[col] : 0];
+            dispgfxDrawCell(row, col, glyph, attrs[col], idx == cursorIdx);
+            shadowVram[idx] = chars[col];
+            shadowCram[idx] = attrs[col];
+            renderStats.cells++;
+            dispgfxMarkRow(row);
+        }
+    }
+    shadowValid = 1;
+    cursorDrawn = cursorIdx;
+}
+
+// Set glyphDirty for every character-RAM glyph that differs from the one
+// the screen was drawn with. Switching between the built-in font and
+// character RAM redraws everything instead.
+static void dispgfxDiffGlyphs(const dispgfx_frame_t *f) {
+    if (anyGlyphDirty) {
+        memset(glyphDirty, 0, sizeof(glyphDirty));
+        anyGlyphDirty = 0;
+    }
+    if (f->hasCharRam != shadowCharRam) {
+        shadowCharRam = f->hasCharRam;
+        shadowValid = 0;
+    }
+    if (!f->hasCharRam) return;
+    if (!shadowValid) {
+        memcpy(shadowFont, f->charRam, sizeof(shadowFont));
+        return;
+    }
+    for (int g = 0; g < DISPGFX_GLYPHS; g++) {
+        if (memcmp(f->charRam[g], shadowFont[g], DISPGFX_CHAR_H) == 0)
+            continue;
+        memcpy(shadowFont[g], f->charRam[g], DISPGFX_CHAR_H);
+        glyphDirty[g] = 1;
+        anyGlyphDirty = 1;
+        renderStats.glyphs++;
+    }
+}
+
+static void dispgfxRenderFrame(const dispgfx_frame_t *f) {
+    // Switching modes (text geometries included) invalidates every shadow
+    if (f->mode != shadowMode) {
+        shadowMode = f->mode;
+        shadowValid = 0;
+        cursorDrawn = -1;
+        fbBlank = 0;
+        if (f->mode == DISPGFX_MODE_BITMAP) {
+            fbWidth  = DISPGFX_WIDTH;
+            fbHeight = DISPGFX_HEIGHT;
+        } else {
+            fbWidth  = f->cols * DISPGFX_CHAR_W;
+            fbHeight = f->rows * DISPGFX_CHAR_H;
+        }
+    }
+    if (f->mode == DISPGFX_MODE_BITMAP) {
+        fbBlank = 0;
+        dispgfxRenderBitmap(f);
+        return;
+    }
+
     // If no VRAM base set yet, leave framebuffer black
-    if (!vramBase) {
-        memset(framebuf, 0, sizeof(framebuf));
+    if (!f->hasVram) {
+        if (!fbBlank) {
+            memset(framebuf, 0, sizeof(framebuf));
+            fbBlank = 1;
+            shadowValid = 0;
+            cursorDrawn = -1;
+            dirtyRowMin = 0;
+            dirtyRowMax = f->rows - 1;
+        }
         return;
     }
+    fbBlank = 0;
 
     // Blink phase for cursor (toggles every ~500 ms at 60 fps)
     static uint32_t frameCount = 0;
     frameCount++;
-    int cursorVisible = cursorOn && ((frameCount / 30) & 1);
+    int cursorVisible = cursorOn && ((frameCount / 30) & 1) &&
+                        cursorCol < f->cols && cursorRow < f->rows;
+    int cursorIdx = cursorVisible ? cursorRow * f->cols + cursorCol : -1;
+
+    dispgfxDiffGlyphs(f);
+    if (f->cols == 80 && f->rows == 50)
+        dispgfxRenderText(f, 80, 50, cursorIdx);
+    else if (f->cols == 80)
+        dispgfxRenderText(f, 80, 25, cursorIdx);
+    else
+        dispgfxRenderText(f, 40, 30, cursorIdx);
+}
 
-    for (int row = 0; row < DISPGFX_ROWS; row++) {
-        for (int col = 0; col < DISPGFX_COLS; col++) {
-            int idx = row * DISPGFX_COLS + col;
-            uint8_t ch   = mem6502[(vramBase + idx) & 0xFFFF];
-            uint8_t attr = cramBase
-                               ? mem6502[(cramBase + idx) & 0xFFFF]
-                               : 0x07; // default: light grey on black
-
-            uint32_t fg = palette[attr & 0x0F];
-            uint32_t bg = palette[(attr >> 4) & 0x0F];
-
-            // Invert colours at cursor position
-            if (cursorVisible && col == cursorCol && row == cursorRow) {
-                uint32_t tmp = fg;
-                fg = bg;
-                bg = tmp;
-            }
+static void dispgfxRender(void) {
+    dirtyRowMin = DISPGFX_MAX_ROWS;
+    dirtyRowMax = -1;
 
-            // Clamp character index to font table range
-            uint8_t ci = (ch < 128) ? ch : 0;
+    // Live display: take this tick's frame ourselves
+    if (!presentMode) dispgfxPublish(1);
 
-            // Blit the 8×8 glyph
-            for (int py = 0; py < DISPGFX_CHAR_H; py++) {
-                uint8_t fontRow = font8x8[ci][py];
-                int fbY = row * DISPGFX_CHAR_H + py;
+    pthread_mutex_lock(&frameLock);
+    dispgfxRenderFrame(&frames[frontFrame]);
+    pthread_mutex_unlock(&frameLock);
+}
 
-                for (int px = 0; px < DISPGFX_CHAR_W; px++) {
-                    int fbX = col * DISPGFX_CHAR_W + px;
-                    int bit = (fontRow >> (7 - px)) & 1;
-                    framebuf[fbY * DISPGFX_WIDTH + fbX] = bit ? fg : bg;
-                }
-            }
-        }
+// ─── Frame consumers (dispvid.c, dispshm.c) ─────────────────────────────────
+// Every 60 Hz tick, after the frame is shown: raster thread, terminal loop
+// or dispgfxFrameTick, whichever drives the display.
+
+static void dispgfxFrameOut(uint32_t frame) {
+    if (!recording && !exporting) return;
+    dispgfx_cursor_t c = {cursorOn, cursorCol, cursorRow};
+    pthread_mutex_lock(&frameLock);
+    if (recording) dispvidFrame(&frames[frontFrame], &c, frame);
+    if (exporting) dispshmFrame(&frames[frontFrame], &c, frame);
+    pthread_mutex_unlock(&frameLock);
+}
+
+// ─── Raster thread (produces finished frames) ───────────────────────────────
+// Rasterizes into framebuf at ~60 Hz and hands each changed frame to the
+// main thread through the triple buffer. Started by dispgfxRenderLoop(), so
+// headless runs (which render on demand) never have one.
+
+static void dispgfxPublishSlot(void) {
+    // Only the frame's dirty band changed, but the back slot may be two
+    // frames old: copy it whole.
+    dispgfx_slot_t *s = &slots[slotBack];
+    memcpy(s->px, framebuf, (size_t)fbWidth * (size_t)fbHeight * sizeof(uint32_t));
+    s->width  = fbWidth;
+    s->height = fbHeight;
+    s->rowMin = dirtyRowMin;
+    s->rowMax = dirtyRowMax;
+
+    pthread_mutex_lock(&slotLock);
+    if (slotFresh) {
+        // The main thread never showed the previous frame: drop it, but its
+        // rows still have to reach the texture with this one
+        dispgfx_slot_t *old = &slots[slotReady];
+        if (old->rowMin < s->rowMin) s->rowMin = old->rowMin;
+        if (old->rowMax > s->rowMax) s->rowMax = old->rowMax;
+        renderStats.dropped++;
+    }
+    int t = slotReady;
+    slotReady = slotBack;
+    slotBack = t;
+    slotFresh = 1;
+    pthread_mutex_unlock(&slotLock);
+
+    // Wake the event wait in dispgfxRenderLoop()
+    SDL_Event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = frameEvent;
+    SDL_PushEvent(&ev);
+}
+
+static void *dispgfxRasterWorker(void *args) {
+    (void)args;
+    const uint64_t freq = SDL_GetPerformanceFrequency();
+    const uint64_t tick = freq / 60;
+    uint64_t next = SDL_GetPerformanceCounter();
+    uint32_t frame = 0;
+
+    while (running) {
+        uint64_t t0 = SDL_GetPerformanceCounter();
+        dispgfxFrameBoundary();
+        dispgfxRender();
+        if (dirtyRowMax >= dirtyRowMin) dispgfxPublishSlot();
+        dispgfxFrameOut(frame);
+        frame++;
+        double us = (double)(SDL_GetPerformanceCounter() - t0) * 1e6 /
+                    (double)freq;
+        renderStats.frames++;
+        renderStats.totalUs += us;
+        if (us > renderStats.maxUs) renderStats.maxUs = us;
+
+        // Frame done: latch VBLANK until the CPU reads STATUS
+        dispgfxSetStatus(DISPGFX_STATUS_VBLANK, 0);
+        if (irqEnable & DISPGFX_IRQ_VBLANK) irqcRaise(IRQC_SRC_DISPGFX);
+
+        // Fixed 60 Hz schedule; after a stall, restart it instead of
+        // bursting to catch up
+        next += tick;
+        uint64_t now = SDL_GetPerformanceCounter();
+        if (now < next)
+            SDL_Delay((uint32_t)((next - now) * 1000 / freq));
+        else
+            next = now;
     }
+    return NULL;
 }
 
-// ─── Main-thread SDL event + render loop ─────────────────────────────────────
+// ─── Terminal loop (-u tui, drawing in disptui.c) ───────────────────────────
+
+static void dispgfxTuiLoop(void) {
+    const uint64_t freq = SDL_GetPerformanceFrequency();
+    const uint64_t tick = freq / 60;
+    uint64_t next = SDL_GetPerformanceCounter();
+    uint32_t frame = 0;
+
+    while (running) {
+        dispgfxFrameBoundary();
+        if (!presentMode) dispgfxPublish(1);
+        dispgfx_cursor_t c = {cursorOn, cursorCol, cursorRow};
+        pthread_mutex_lock(&frameLock);
+        disptuiFrame(&frames[frontFrame], &c);
+        pthread_mutex_unlock(&frameLock);
+        dispgfxFrameOut(frame);
+        frame++;
+
+        dispgfxSetStatus(DISPGFX_STATUS_VBLANK, 0);
+        if (irqEnable & DISPGFX_IRQ_VBLANK) irqcRaise(IRQC_SRC_DISPGFX);
+
+        disptuiCheckSize();
+
+        next += tick;
+        uint64_t now = SDL_GetPerformanceCounter();
+        if (now < next)
+            SDL_Delay((uint32_t)((next - now) * 1000 / freq));
+        else
+            next = now;
+    }
+}
+
+// ─── Main-thread SDL event + present loop ────────────────────────────────────
 // This MUST run on the main thread (macOS requirement).
 // fake6502Init() should spawn the CPU loop on a pthread, then call this.
 
-void dispgfxRenderLoop(void) {
-    SDL_Event ev;
+static void dispgfxResizeTexture(int w, int h) {
+    SDL_Texture *t = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888,
+                                       SDL_TEXTUREACCESS_STREAMING, w, h);
+    if (!t) {
+        fprintf(stderr, "[DISPGFX] SDL_CreateTexture(%dx%d) failed: %s\n",
+                w, h, SDL_GetError());
+        return;
+    }
+    SDL_DestroyTexture(sdlTexture);
+    sdlTexture = t;
+    texWidth = w;
+    texHeight = h;
+}
 
-    while (running) {
-        // ── Handle SDL events ────────────────────────────────────────────────
-        while (SDL_PollEvent(&ev)) {
-            switch (ev.type) {
-
-            case SDL_QUIT:
-                running = 0;
-                return;
-
-            case SDL_KEYDOWN: {
-                SDL_Keycode sym = ev.key.keysym.sym;
-
-                // Special keys → send escape sequences or control chars
-                switch (sym) {
-                case SDLK_ESCAPE:   running = 0; return;
-                case SDLK_RETURN:
-                case SDLK_KP_ENTER: dispgfxForwardKey(0x0D); break;
-                case SDLK_BACKSPACE:dispgfxForwardKey(0x08); break;
-                case SDLK_TAB:      dispgfxForwardKey(0x09); break;
-                case SDLK_DELETE:   dispgfxForwardKey(0x7F); break;
-
-                // Arrow keys → VT100 escape sequences
-                case SDLK_UP:
-                    dispgfxForwardKey(0x1B);
-                    dispgfxForwardKey('[');
-                    dispgfxForwardKey('A');
-                    break;
-                case SDLK_DOWN:
-                    dispgfxForwardKey(0x1B);
-                    dispgfxForwardKey('[');
-                    dispgfxForwardKey('B');
-                    break;
-                case SDLK_RIGHT:
-                    dispgfxForwardKey(0x1B);
-                    dispgfxForwardKey('[');
-                    dispgfxForwardKey('C');
-                    break;
-                case SDLK_LEFT:
-                    dispgfxForwardKey(0x1B);
-                    dispgfxForwardKey('[');
-                    dispgfxForwardKey('D');
-                    break;
-
-                default:
-                    // Ctrl+letter → send control code
-                    if ((ev.key.keysym.mod & KMOD_CTRL) &&
-                        sym >= SDLK_a && sym <= SDLK_z) {
-                        dispgfxForwardKey((uint8_t)(sym - SDLK_a + 1));
-                    }
-                    break;
-                }
-                break;
-            }
+// Returns 0 when the event asks the emulator to quit
+static int dispgfxHandleEvent(const SDL_Event *ev) {
+    switch (ev->type) {
+
+    case SDL_QUIT:
+        return 0;
+
+    case SDL_KEYDOWN: {
+        SDL_Keycode sym = ev->key.keysym.sym;
+
+        // Special keys → send escape sequences or control chars
+        switch (sym) {
+        case SDLK_ESCAPE:   return 0;
+        case SDLK_RETURN:
+        case SDLK_KP_ENTER: dispgfxForwardKey(0x0D); break;
+        case SDLK_BACKSPACE:dispgfxForwardKey(0x08); break;
+        case SDLK_TAB:      dispgfxForwardKey(0x09); break;
+        case SDLK_DELETE:   dispgfxForwardKey(0x7F); break;
+
+        // Arrow keys → VT100 escape sequences
+        case SDLK_UP:
+            dispgfxForwardKey(0x1B);
+            dispgfxForwardKey('[');
+            dispgfxForwardKey('A');
+            break;
+        case SDLK_DOWN:
+            dispgfxForwardKey(0x1B);
+            dispgfxForwardKey('[');
+            dispgfxForwardKey('B');
+            break;
+        case SDLK_RIGHT:
+            dispgfxForwardKey(0x1B);
+            dispgfxForwardKey('[');
+            dispgfxForwardKey('C');
+            break;
+        case SDLK_LEFT:
+            dispgfxForwardKey(0x1B);
+            dispgfxForwardKey('[');
+            dispgfxForwardKey('D');
+            break;
 
-            case SDL_TEXTINPUT: {
-                // Forward each UTF-8 byte (only ASCII range will be useful)
-                const char *text = ev.text.text;
-                while (*text) {
-                    uint8_t c = (uint8_t)*text++;
-                    if (c < 128) {
-                        dispgfxForwardKey(c);
-                    }
-                }
-                break;
+        default:
+            // Ctrl+letter → send control code
+            if ((ev->key.keysym.mod & KMOD_CTRL) &&
+                sym >= SDLK_a && sym <= SDLK_z) {
+                dispgfxForwardKey((uint8_t)(sym - SDLK_a + 1));
             }
+            break;
+        }
+        break;
+    }
 
-            default:
-                break;
+    case SDL_TEXTINPUT: {
+        // Forward each UTF-8 byte (only ASCII range will be useful)
+        const char *text = ev->text.text;
+        while (*text) {
+            uint8_t c = (uint8_t)*text++;
+            if (c < 128) {
+                dispgfxForwardKey(c);
             }
         }
+        break;
+    }
 
-        // ── Render one frame ─────────────────────────────────────────────────
-        dispgfxRender();
+    case SDL_WINDOWEVENT:
+        // Exposed/resized: the window needs a present even without a frame
+        needPresent = 1;
+        break;
+
+    default:
+        break;
+    }
+    return 1;
+}
 
-        // Set VBLANK bit briefly (6502 can poll this for timing)
-        if (dispgfxStatusRegAddr) {
-            mem6502[dispgfxStatusRegAddr] |= DISPGFX_STATUS_VBLANK;
+void dispgfxRenderLoop(void) {
+    SDL_Event ev;
+    pthread_t raster;
+    uint8_t   shownBorder = 0xFF;
+
+    if (dispgfxTui) {
+        dispgfxTuiLoop();
+        return;
+    }
+
+    frameEvent = SDL_RegisterEvents(1);
+    needPresent = 1;
+    pthread_create(&raster, NULL, &dispgfxRasterWorker, NULL);
+
+    while (running) {
+        // ── Handle SDL events (a finished frame also wakes the wait) ────────
+        if (SDL_WaitEventTimeout(&ev, 16)) {
+            do {
+                if (!dispgfxHandleEvent(&ev)) running = 0;
+            } while (running && SDL_PollEvent(&ev));
+        }
+        if (!running) break;
+
+        // ── Take the newest finished frame, if any ───────────────────────────
+        int fresh = 0;
+        pthread_mutex_lock(&slotLock);
+        if (slotFresh) {
+            int t = slotFront;
+            slotFront = slotReady;
+            slotReady = t;
+            slotFresh = 0;
+            fresh = 1;
+        }
+        pthread_mutex_unlock(&slotLock);
+
+        // A mode switch changed the frame size: new texture. The frame
+        // redrew every row, so the upload below fills all of it.
+        const dispgfx_slot_t *s = &slots[slotFront];
+        if (fresh && (s->width != texWidth || s->height != texHeight))
+            dispgfxResizeTexture(s->width, s->height);
+
+        // Only the rows that changed: the texture keeps the rest
+        if (fresh && s->rowMax >= s->rowMin) {
+            SDL_Rect band = {
+                0, s->rowMin * DISPGFX_CHAR_H, s->width,
+                (s->rowMax - s->rowMin + 1) * DISPGFX_CHAR_H};
+            SDL_UpdateTexture(sdlTexture, &band,
+                              &s->px[band.y * s->width],
+                              s->width * (int)sizeof(uint32_t));
+            renderStats.rows += (uint64_t)(s->rowMax - s->rowMin + 1);
         }
 
-        SDL_UpdateTexture(sdlTexture, NULL, framebuf,
-                          DISPGFX_WIDTH * sizeof(uint32_t));
+        uint8_t border = borderColour;
+        if (!fresh && !needPresent && border == shownBorder) continue;
+        needPresent = 0;
+        shownBorder = border;
+        renderStats.presents++;
 
         // Border colour behind the texture
-        uint32_t bc = palette[borderColour];
+        uint32_t bc = palette[border];
         SDL_SetRenderDrawColor(sdlRenderer,
                                (bc >> 16) & 0xFF,
                                (bc >>  8) & 0xFF,
@@ -547,17 +1477,96 @@ void dispgfxRenderLoop(void) {
         SDL_RenderClear(sdlRenderer);
         SDL_RenderCopy(sdlRenderer, sdlTexture, NULL, NULL);
         SDL_RenderPresent(sdlRenderer);
+    }
 
-        // Clear VBLANK (it was set for one frame)
-        if (dispgfxStatusRegAddr) {
-            mem6502[dispgfxStatusRegAddr] &= ~DISPGFX_STATUS_VBLANK;
-        }
+    pthread_join(raster, NULL);
+}
+
+// ─── Headless frames and screenshots ────────────────────────────────────────
+
+// Render the current screen into framebuf and write it as a binary PPM
+static int dispgfxDump(const char *path) {
+    dispgfxRender();
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "[DISPGFX] cannot write %s: ", path);
+        perror("fopen(): ");
+        return -1;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", fbWidth, fbHeight);
+    static uint8_t rgb[DISPGFX_MAX_WIDTH * DISPGFX_MAX_HEIGHT * 3];
+    for (int i = 0; i < fbWidth * fbHeight; i++) {
+        rgb[3 * i]     = (uint8_t)(framebuf[i] >> 16);
+        rgb[3 * i + 1] = (uint8_t)(framebuf[i] >> 8);
+        rgb[3 * i + 2] = (uint8_t)framebuf[i];
+    }
+    fwrite(rgb, 3, (size_t)fbWidth * (size_t)fbHeight, f);
+    fclose(f);
+    return 0;
+}
+
+void dispgfxFrameTick(void) {
+    static uint32_t frame = 0;
+    frame++;
+
+    dispgfxFrameBoundary();
+    dispgfxSetStatus(DISPGFX_STATUS_VBLANK, 0);
+    if (irqEnable & DISPGFX_IRQ_VBLANK) irqcRaise(IRQC_SRC_DISPGFX);
+
+    if (recording || exporting) {
+        // CPU thread: guest memory is not changing, no need to verify
+        if (!presentMode) dispgfxPublish(0);
+        dispgfxFrameOut(frame);
+    }
+
+    if (dispgfxDumpFile && dispgfxDumpEvery && frame % dispgfxDumpEvery == 0) {
+        // shot.ppm → shot-000120.ppm
+        char path[FILENAME_MAX];
+        const char *dot = strrchr(dispgfxDumpFile, '.');
+        int stem = dot ? (int)(dot - dispgfxDumpFile)
+                       : (int)strlen(dispgfxDumpFile);
+        snprintf(path, sizeof(path), "%.*s-%06u%s", stem, dispgfxDumpFile,
+                 (unsigned)frame, dot ? dot : ".ppm");
+        dispgfxDump(path);
     }
 }
 
 // ─── Cleanup ─────────────────────────────────────────────────────────────────
 
 void dispgfxCleanup(void) {
+    if (dispgfxTui) disptuiCleanup();
+    if (exporting) dispshmClose();
+    if (recording) dispvidClose();
+    if (dispgfxHeadless) {
+        if (dispgfxDumpFile && dispgfxDump(dispgfxDumpFile) == 0)
+            fprintf(stderr, "[DISPGFX] screen written to %s\n",
+                    dispgfxDumpFile);
+        return;
+    }
+    if (renderStats.frames) {
+        double n = (double)renderStats.frames;
+        fprintf(stderr,
+                "[DISPGFX] %llu frames: render avg %.1f us, max %.1f us; "
+                "%.1f cells redrawn per frame\n",
+                (unsigned long long)renderStats.frames,
+                renderStats.totalUs / n, renderStats.maxUs,
+                (double)renderStats.cells / n);
+        fprintf(stderr,
+                "[DISPGFX] %llu presents, %llu frames dropped, "
+                "%.1f rows uploaded per present\n",
+                (unsigned long long)renderStats.presents,
+                (unsigned long long)renderStats.dropped,
+                renderStats.presents ? (double)renderStats.rows /
+                                           (double)renderStats.presents
+                                     : 0.0);
+        if (renderStats.glyphs)
+            fprintf(stderr, "[DISPGFX] %llu character-RAM glyphs redefined\n",
+                    (unsigned long long)renderStats.glyphs);
+    }
+    if (captureRetries) {
+        fprintf(stderr, "[DISPGFX] %llu live captures retried (torn by CPU)\n",
+                (unsigned long long)captureRetries);
+    }
     if (sdlTexture)  { SDL_DestroyTexture(sdlTexture);   sdlTexture  = NULL; }
     if (sdlRenderer) { SDL_DestroyRenderer(sdlRenderer); sdlRenderer = NULL; }
     if (sdlWindow)   { SDL_DestroyWindow(sdlWindow);     sdlWindow   = NULL; }
@@ -12,6 +12,21 @@
 #define DISPGFX_SCALE           3           // window = 960 × 720
 #define DISPGFX_VRAM_SIZE       (DISPGFX_COLS * DISPGFX_ROWS)    // 1200
 
+// Largest text mode (80×50): sizes the host-side buffers
+#define DISPGFX_MAX_COLS        80
+#define DISPGFX_MAX_ROWS        50
+#define DISPGFX_MAX_WIDTH       (DISPGFX_MAX_COLS * DISPGFX_CHAR_W)  // 640
+#define DISPGFX_MAX_HEIGHT      (DISPGFX_MAX_ROWS * DISPGFX_CHAR_H)  // 400
+#define DISPGFX_VRAM_MAX        (DISPGFX_MAX_COLS * DISPGFX_MAX_ROWS) // 4000
+
+// Bitmap mode: 320×240, 4 bpp (two pixels per byte, left pixel in the
+// high nibble), rows of DISPGFX_BITMAP_PITCH bytes
+#define DISPGFX_BITMAP_PITCH    (DISPGFX_WIDTH / 2)              // 160
+#define DISPGFX_BITMAP_SIZE     (DISPGFX_BITMAP_PITCH * DISPGFX_HEIGHT) // 38400
+#define DISPGFX_BANK_SIZE       2048
+#define DISPGFX_BANKS                                                          \
+    ((DISPGFX_BITMAP_SIZE + DISPGFX_BANK_SIZE - 1) / DISPGFX_BANK_SIZE)  // 19
+
 // ─── Commands (6502 → CMD register) ──────────────────────────────────────────
 #define DISPGFX_CMD_NOP          0x00
 #define DISPGFX_CMD_SET_VRAM     0x01  // DATA = 16-bit LE base of char VRAM
@@ -21,11 +36,108 @@
 #define DISPGFX_CMD_CURSOR_ON    0x05  // enable blinking cursor
 #define DISPGFX_CMD_CURSOR_OFF   0x06  // disable cursor
 #define DISPGFX_CMD_SET_BORDER   0x07  // DATA low = border colour index (0-15)
+#define DISPGFX_CMD_SCROLL_UP    0x08  // DATA low = rows, DATA high = attr
+#define DISPGFX_CMD_SCROLL_DOWN  0x09  // DATA low = rows, DATA high = attr
+#define DISPGFX_CMD_FILL_RECT    0x0A  // DATA = address of a fill block
+#define DISPGFX_CMD_COPY_RECT    0x0B  // DATA = address of a copy block
+#define DISPGFX_CMD_SET_MODE     0x0C  // DATA low = DISPGFX_MODE_*
+#define DISPGFX_CMD_SET_WINDOW   0x0D  // DATA = base of the 2 KB bank window
+#define DISPGFX_CMD_SET_BANK     0x0E  // DATA low = bank (0-18)
+#define DISPGFX_CMD_DRAW_LINE    0x0F  // DATA = address of a line block
+#define DISPGFX_CMD_BLIT_FILL    0x10  // DATA = address of a fill block
+#define DISPGFX_CMD_BLIT_COPY    0x11  // DATA = address of a copy block
+#define DISPGFX_CMD_BLIT_IMAGE   0x12  // DATA = address of an image block
+#define DISPGFX_CMD_SET_IRQ      0x13  // DATA low = DISPGFX_IRQ_* enable mask
+#define DISPGFX_CMD_PRESENT      0x14  // show VRAM/CRAM/bitmap as they are now
+#define DISPGFX_CMD_GET_GEOMETRY 0x15  // DATA ← text cols (low), rows (high)
+#define DISPGFX_CMD_SET_CHARRAM  0x16  // DATA = base of 2 KB glyphs, 0 = ROM
+#define DISPGFX_CMD_FLIP         0x17  // DATA = address of a flip block
+
+#define DISPGFX_MODE_TEXT        0x00  // 40×30 characters (default)
+#define DISPGFX_MODE_BITMAP      0x01  // 320×240, 16 colours
+#define DISPGFX_MODE_TEXT80X25   0x02  // 80×25 characters (640×200)
+#define DISPGFX_MODE_TEXT80X50   0x03  // 80×50 characters (640×400)
+
+#define DISPGFX_IRQ_VBLANK       0x01  // raise an IRQ once per frame
+
+// ─── Text geometry ───────────────────────────────────────────────────────────
+// SET_MODE with a text mode selects 40×30, 80×25 or 80×50. VRAM and CRAM are
+// then cols × rows bytes each (row-major), the ring restarts at row 0 and
+// the cursor goes home; the buffers are neither moved nor cleared, so a
+// guest switching to 80 columns must first SET_VRAM/SET_CRAM to areas
+// large enough. After SET_MODE, and after GET_GEOMETRY, the DATA register
+// holds the current text geometry: cols in the low byte, rows in the high
+// byte (bitmap mode reports the last text geometry). The window size does
+// not change; every mode is scaled to fill it.
+
+// ─── Character RAM ───────────────────────────────────────────────────────────
+// SET_CHARRAM points text modes at DISPGFX_CHARRAM_SIZE bytes of guest RAM
+// holding all 256 glyphs: glyph n is the 8 bytes at base + n * 8, top row
+// first, MSB leftmost. The guest edits them in place; the display picks
+// changes up like VRAM writes, redrawing only the cells whose glyph
+// changed. SET_CHARRAM 0 returns to the built-in font (ASCII 0-127,
+// characters 128-255 blank).
+#define DISPGFX_GLYPHS          256
+#define DISPGFX_CHARRAM_SIZE    (DISPGFX_GLYPHS * DISPGFX_CHAR_H)  // 2048
+
+// ─── Hardware scroll ─────────────────────────────────────────────────────────
+// VRAM and CRAM are a ring of `rows` rows: screen row r shows buffer
+// row (start + r) % rows. SCROLL_UP/SCROLL_DOWN only move `start` and
+// blank the rows that come into view (spaces, DATA-high attribute), so
+// nothing is copied. CLEAR resets start to 0. SET_CURSOR and the rectangle
+// commands take screen coordinates; a guest writing VRAM directly must
+// apply the ring itself.
+//
+// Rectangle parameter blocks in guest RAM (screen coordinates, clipped):
+//   FILL_RECT  +0 planes  +1 col  +2 row  +3 width  +4 height
+//              +5 char    +6 attr
+//   COPY_RECT  +0 planes  +1 srcCol  +2 srcRow  +3 dstCol  +4 dstRow
+//              +5 width   +6 height           (overlap is safe)
+#define DISPGFX_PLANE_VRAM       0x01
+#define DISPGFX_PLANE_CRAM       0x02
+
+// ─── Bitmap mode and blitter ─────────────────────────────────────────────────
+// The 38400-byte bitmap lives on the host. The guest sees one
+// DISPGFX_BANK_SIZE slice of it at a time through a window in its own RAM
+// (SET_WINDOW): SET_BANK writes the window back to the bank it held and
+// loads the new bank into it. Reads and writes of the window are plain RAM
+// accesses; the display shows them live. The last bank is 1536 bytes.
+//
+// Blitter commands work on the whole bitmap (window included), clip to the
+// screen and use palette indices 0-15. Parameter blocks in guest RAM, x and
+// width are 16-bit LE:
+//   DRAW_LINE   +0 x0  +2 y0  +3 x1  +5 y1  +6 colour
+//   BLIT_FILL   +0 x   +2 y   +3 w   +5 h   +6 colour
+//   BLIT_COPY   +0 srcX  +2 srcY  +3 dstX  +5 dstY  +6 w  +8 h
+//               (overlap is safe)
+//   BLIT_IMAGE  +0 src address  +2 dstX  +4 dstY  +5 w  +7 h  +8 key
+//               (source is 4 bpp, (w + 1) / 2 bytes per row; pixels equal
+//                to `key` are skipped, key $FF = opaque)
+// CLEAR in bitmap mode fills the bitmap with colour 0.
+
+// ─── Frame presentation ──────────────────────────────────────────────────────
+// The renderer never reads guest memory while drawing; it draws a private
+// copy. Until the guest first sends PRESENT, that copy is taken every frame
+// and retaken if the CPU wrote VRAM/CRAM mid-copy. From the first PRESENT
+// on, the display shows only what each PRESENT captured (with the CPU
+// parked in its wait for IDLE), so a guest can update a whole screen
+// without the intermediate states ever being shown.
+
+// ─── Page flipping ───────────────────────────────────────────────────────────
+// FLIP replaces the displayed VRAM and CRAM bases at the next frame
+// boundary, both at once. The block in guest RAM holds the new bases:
+//   FLIP  +0 VRAM base  +2 CRAM base     (16-bit LE)
+// STATUS_FLIP is set by FLIP and cleared when the new page is on screen;
+// until then the guest must not draw into the page being replaced. A
+// SET_VRAM or SET_CRAM before the boundary cancels the pending FLIP (and
+// clears STATUS_FLIP). The scroll ring position and the cursor are shared
+// by both pages.
 
 // ─── Status register bits ────────────────────────────────────────────────────
 #define DISPGFX_STATUS_IDLE      0x01
 #define DISPGFX_STATUS_BUSY      0x02
-#define DISPGFX_STATUS_VBLANK    0x04  // set once per frame
+#define DISPGFX_STATUS_VBLANK    0x04  // latched once per frame, read clears
+#define DISPGFX_STATUS_FLIP      0x08  // FLIP waiting for the frame boundary
 
 // ─── Device-table addresses in ROM ───────────────────────────────────────────
 //  $FF0A-$FF0B  →  address of dispgfx CMD register
@@ -44,6 +156,29 @@
 //   bits 3-0  →  foreground colour index
 // Default (if no CRAM set): light grey on black (0x07)
 
+// ─── Captured frames ─────────────────────────────────────────────────────────
+// The private copy the display draws (see Frame presentation). dispgfx.c
+// hands the front frame, locked, to the terminal backend (disptui.c), the
+// video recorder (dispvid.c) and the shared-memory export (dispshm.c); none
+// of them touch guest memory or the device state.
+typedef struct dispgfx_frame_t {
+    int      mode;                          // DISPGFX_MODE_* at capture
+    int      hasVram;                       // text mode: VRAM base set
+    int      cols, rows;                    // text geometry at capture
+    uint8_t  scroll;                        // ring start row at capture
+    int      hasCharRam;                    // glyphs below, not the font
+    uint8_t  vram[DISPGFX_VRAM_MAX];        // screen order (ring applied)
+    uint8_t  cram[DISPGFX_VRAM_MAX];
+    uint8_t  charRam[DISPGFX_GLYPHS][DISPGFX_CHAR_H];
+    uint8_t  bitmap[DISPGFX_BITMAP_SIZE];   // window contents included
+} dispgfx_frame_t;
+
+// Cursor as set by the guest when the frame is handed out (not blinked)
+typedef struct dispgfx_cursor_t {
+    int      on;
+    uint8_t  col, row;
+} dispgfx_cursor_t;
+
 // ─── Register address globals (loaded from device table at init) ─────────────
 extern uint16_t dispgfxCmdRegAddr;
 extern uint16_t dispgfxDataRegAddr;
@@ -59,9 +194,48 @@ extern void dispgfxInit(void);
 // Command-processing worker thread (same pattern as other devices).
 extern void *dispgfxWorker(void *args);
 
-// Main-thread SDL event + render loop.  Blocks until running == 0.
+// Main-thread SDL event + present loop.  Blocks until running == 0.
+// Starts the raster thread, which rasterizes frames into a triple buffer;
+// this loop only forwards input and presents the newest finished frame.
 // On macOS, SDL MUST be driven from the main thread.
+// With dispgfxTui it runs the terminal loop instead (see below).
 extern void dispgfxRenderLoop(void);
 
+// CPU-side read of the STATUS register (called with dispgfxLock held).
+// Returns the status and clears the latched VBLANK bit.
+extern uint8_t dispgfxStatusRead(void);
+
 // Clean up SDL resources.  Called after the render loop exits.
+// Headless: writes the final screen to dispgfxDumpFile, if set.
 extern void dispgfxCleanup(void);
+
+// ─── Headless mode (--headless) ──────────────────────────────────────────────
+// No SDL at all: dispgfxInit skips the window and dispgfxRenderLoop is not
+// run. The CPU thread calls dispgfxFrameTick once per emulated frame
+// (EMU_CPU_HZ / 60 cycles) for VBLANK; the screen is only rasterized to
+// write a PPM, at exit and every dispgfxDumpEvery frames (0 = never) as
+// <stem>-<frame>.ppm.
+extern int         dispgfxHeadless;
+extern const char *dispgfxDumpFile;
+extern uint32_t    dispgfxDumpEvery;
+
+// --record-video: every frame that changed is appended to this file as
+// cell changes (format in dispvid.h; tools/bbvid expands it to video).
+// Works with and without a window. NULL = off.
+extern const char *dispgfxRecordFile;
+
+// --shm <name>: publish the text screen, cursor and frame counter to the
+// POSIX shared-memory object DISPSHM_PREFIX<name> every frame (layout and
+// seqlock in dispshm.h; tools/bbview shows it). NULL = off.
+extern const char *dispgfxShmName;
+
+extern void dispgfxFrameTick(void);
+
+// ─── Terminal mode (-u tui) ──────────────────────────────────────────────────
+// No window: dispgfxInit takes over the terminal with curses and
+// dispgfxRenderLoop draws each text cell as one character cell (the
+// built-in font as ASCII, character RAM by closest match or ink coverage,
+// the palette as colour pairs). A frame writes only the cells that changed
+// since the previous one. Bitmap mode shows each 8×8 block in its most
+// common colour. Input is left to the keyboard device (Esc quits).
+extern int dispgfxTui;
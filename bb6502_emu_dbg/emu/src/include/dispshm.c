@@ -0,0 +1,99 @@
+// dispshm.c — Shared-memory export for dispgfx (--shm, layout in dispshm.h)
+//
+// Each frame the text screen goes to a shared-memory object for viewers in
+// other processes: the cells in use (2.4 KB at 40×30) and the cursor, under
+// a seqlock, from the same captured frame the display shows.
+
+#include "dispshm.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static dispshm_t *shm = NULL;
+static char       shmPath[64];
+static uint64_t   shmFrames = 0;
+
+int dispshmOpen(const char *name, const uint32_t *palette) {
+#ifdef _WIN32
+    (void)name;
+    (void)palette;
+    fprintf(stderr, "[DISPGFX] --shm is not supported on this platform\n");
+    return -1;
+#else
+    snprintf(shmPath, sizeof(shmPath), DISPSHM_PREFIX "%s", name);
+    int fd = shm_open(shmPath, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[DISPGFX] cannot create %s: ", shmPath);
+        perror("shm_open(): ");
+        return -1;
+    }
+    void *p = MAP_FAILED;
+    if (ftruncate(fd, (off_t)sizeof(dispshm_t)) == 0)
+        p = mmap(NULL, sizeof(dispshm_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+                 fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "[DISPGFX] cannot map %s: ", shmPath);
+        perror("mmap(): ");
+        shm_unlink(shmPath);
+        return -1;
+    }
+
+    // A viewer may still hold the object from an earlier run: it sees the
+    // magic vanish and come back rather than a half-initialised header
+    shm = p;
+    memset(shm->magic, 0, sizeof(shm->magic));
+    atomic_store(&shm->seq, 0);
+    atomic_store(&shm->closed, 0);
+    shm->version = DISPSHM_VERSION;
+    memcpy(shm->palette, palette, sizeof(shm->palette));
+    shm->frame = 0;
+    shm->hasVram = 0;
+    atomic_thread_fence(memory_order_release);
+    memcpy(shm->magic, DISPSHM_MAGIC, sizeof(shm->magic));
+    fprintf(stderr, "[DISPGFX] exporting the screen to %s\n", shmPath);
+    return 0;
+#endif
+}
+
+void dispshmFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c,
+                  uint32_t frame) {
+    uint32_t seq = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+    atomic_store_explicit(&shm->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    shm->frame      = frame;
+    shm->mode       = (uint8_t)f->mode;
+    shm->hasVram    = f->mode != DISPGFX_MODE_BITMAP && f->hasVram;
+    shm->cols       = (uint8_t)f->cols;
+    shm->rows       = (uint8_t)f->rows;
+    shm->hasCharRam = (uint8_t)f->hasCharRam;
+    shm->cursorOn   = (uint8_t)c->on;
+    shm->cursorCol  = c->col;
+    shm->cursorRow  = c->row;
+    if (shm->hasVram) {
+        memcpy(shm->vram, f->vram, (size_t)(f->cols * f->rows));
+        memcpy(shm->cram, f->cram, (size_t)(f->cols * f->rows));
+    }
+
+    atomic_store_explicit(&shm->seq, seq + 2, memory_order_release);
+    shmFrames++;
+}
+
+void dispshmClose(void) {
+#ifndef _WIN32
+    atomic_store(&shm->closed, 1);
+    munmap(shm, sizeof(dispshm_t));
+    shm = NULL;
+    shm_unlink(shmPath);
+    fprintf(stderr, "[DISPGFX] %llu frames exported to %s\n",
+            (unsigned long long)shmFrames, shmPath);
+#endif
+}
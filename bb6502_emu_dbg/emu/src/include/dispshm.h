@@ -0,0 +1,59 @@
+#pragma once
+
+// ─── dispgfx shared-memory export (--shm) ───────────────────────────────────
+// dispshm.c publishes the text screen into the POSIX shared-memory object
+// DISPSHM_PREFIX<name> once per frame; tools/bbview maps any number of them
+// read-only and draws them side by side. Not available on _WIN32.
+//
+// Seqlock: the emulator makes `seq` odd, rewrites the frame fields, then
+// makes it even again. A reader copies what it needs between two reads of
+// `seq` and starts over if they differ or the first was odd, so it never
+// holds up the emulator and never uses a half-written frame.
+
+#include "dispgfx.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define DISPSHM_MAGIC    "BB65SHM"
+#define DISPSHM_VERSION  1
+#define DISPSHM_PREFIX   "/bb6502-"
+
+typedef struct dispshm_t {
+    char     magic[8];          // DISPSHM_MAGIC, written last at creation
+    uint32_t version;
+    _Atomic uint32_t closed;    // 1 once the emulator has exited
+    uint32_t palette[DISPGFX_NUM_COLOURS];  // ARGB8888
+    _Atomic uint32_t seq;       // odd while a frame is being written
+
+    // Frame, valid between two equal even reads of seq
+    uint32_t frame;             // 60 Hz ticks since start
+    uint8_t  mode;              // DISPGFX_MODE_*; bitmap mode has no cells
+    uint8_t  hasVram;           // 0 = no VRAM base set yet: blank screen
+    uint8_t  cols, rows;        // cells in use: vram/cram[0 .. cols*rows-1]
+    uint8_t  cursorOn, cursorCol, cursorRow;
+    uint8_t  hasCharRam;        // cells are drawn with guest glyphs
+    uint8_t  vram[DISPGFX_VRAM_MAX];        // screen order (scroll applied)
+    uint8_t  cram[DISPGFX_VRAM_MAX];
+} dispshm_t;
+
+// Reader side: take `seq`, copy, then check it is unchanged
+static inline uint32_t dispshmReadBegin(const dispshm_t *s) {
+    return atomic_load_explicit((_Atomic uint32_t *)&s->seq,
+                                memory_order_acquire);
+}
+
+static inline int dispshmReadValid(const dispshm_t *s, uint32_t seq) {
+    atomic_thread_fence(memory_order_acquire);
+    return !(seq & 1) &&
+           atomic_load_explicit((_Atomic uint32_t *)&s->seq,
+                                memory_order_relaxed) == seq;
+}
+
+// ─── Writer side (dispshm.c, driven by dispgfx.c) ───────────────────────────
+// Open creates and maps the object and returns 0, or -1 (already reported).
+// Frame is called with the front frame locked. Close marks the object
+// closed and unlinks it.
+extern int  dispshmOpen(const char *name, const uint32_t *palette);
+extern void dispshmFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c,
+                         uint32_t frame);
+extern void dispshmClose(void);
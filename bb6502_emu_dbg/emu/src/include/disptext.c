@@ -6,6 +6,8 @@
 
 static pthread_t workerThread;
 uint16_t disptextDataRegAddr = 0; // loaded from device table at init
+FILE *disptextOut = NULL;
+int disptextQuiet = 0;
 
 void disptextInit(void) {
   // Device table entry at EMU_DISPTEXT_BASE ($FF08-$FF09):
@@ -13,6 +15,9 @@ void disptextInit(void) {
   disptextDataRegAddr = (uint16_t)read6502(EMU_DISPTEXT_BASE) |
                         ((uint16_t)read6502(EMU_DISPTEXT_BASE + 1) << 8);
 
+  if (!disptextOut && !disptextQuiet)
+    disptextOut = stdout;
+
   pthread_create(&workerThread, NULL, &disptextWorker, NULL);
   pthread_detach(workerThread);
 }
@@ -38,8 +43,10 @@ void *disptextWorker(void *args) {
       break;
     }
 
-    putc(data, stdout);
-    fflush(stdout);
+    if (disptextOut) {
+      putc(data, disptextOut);
+      fflush(disptextOut);
+    }
 
     // Write 0 back: signals to the CPU that the register is free
     write6502(disptextDataRegAddr, 0);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdio.h>
 
 // Written to disptext DATA reg to request worker exit
 #define DISPL_EXIT  0xFF
@@ -14,5 +15,12 @@
 
 extern uint16_t disptextDataRegAddr;
 
+// Where characters go; stdout unless set before disptextInit (--text-out)
+extern FILE *disptextOut;
+
+// Set before disptextInit with no disptextOut: characters are consumed and
+// dropped (the terminal is showing the display, -u tui)
+extern int disptextQuiet;
+
 extern void  disptextInit(void);
 extern void *disptextWorker(void *args);
@@ -0,0 +1,236 @@
+// disptui.c — Terminal backend for dispgfx (-u tui)
+//
+// Stands in for the window when there is no display (e.g. over SSH). The
+// main thread (dispgfxTuiLoop) does what the raster thread and present
+// loop do together: each 60 Hz tick takes the frame, then writes only the
+// cells whose character, colours or glyph changed since the previous tick,
+// so curses has just those to send. The guest's cursor is the terminal's cursor,
+// which blinks by itself. Keys reach the guest through the keyboard device
+// as they always do; a lone Esc quits.
+
+#include "disptui.h"
+
+#include <curses.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// CGA palette index (bit 3 = bright) → curses base colour
+static const short tuiColourMap[8] = {
+    COLOR_BLACK, COLOR_BLUE, COLOR_GREEN, COLOR_CYAN,
+    COLOR_RED, COLOR_MAGENTA, COLOR_YELLOW, COLOR_WHITE,
+};
+
+static int     tuiColours = 0;     // 16, 8 (bright = A_BOLD) or 0 (mono)
+static int     tuiMode    = -1;    // mode the terminal shows
+static int     tuiCols, tuiRows;   // geometry the terminal shows
+static int     tuiValid   = 0;     // 0 = rewrite every cell next tick
+static int     tuiCursor  = -2;    // cell holding the terminal cursor
+static uint8_t tuiVram[DISPGFX_VRAM_MAX];   // what each cell shows
+static uint8_t tuiCram[DISPGFX_VRAM_MAX];   // (bitmap: colour in tuiCram)
+static chtype  tuiGlyph[DISPGFX_GLYPHS];    // terminal character per glyph
+static uint8_t tuiGlyphDirty[DISPGFX_GLYPHS];
+static uint8_t tuiFont[DISPGFX_GLYPHS][DISPGFX_CHAR_H];
+static int     tuiCharRam = -1;    // tuiGlyph is for character RAM
+static const uint8_t (*tuiBuiltin)[DISPGFX_CHAR_H];   // font, ASCII order
+static struct {
+    uint64_t frames;
+    uint64_t cells;                 // terminal cells rewritten
+    uint64_t glyphs;
+} tuiStats;
+
+// Output only: input stays with the keyboard device, which reads the same
+// terminal (kbdInit runs after this, so curses does not undo its raw mode)
+void disptuiInit(const uint8_t (*font)[DISPGFX_CHAR_H]) {
+    tuiBuiltin = font;
+    initscr();
+    if (!has_colors()) return;
+    start_color();
+    // Pair 0 (black on black) must not be the terminal's default colours
+    assume_default_colors(COLOR_BLACK, COLOR_BLACK);
+
+    // Pair = background * N + foreground, N = 16 or 8
+    tuiColours = COLORS >= 16 && COLOR_PAIRS >= 256 ? 16
+                 : COLOR_PAIRS >= 64                ? 8 : 0;
+    for (int p = 1; p < tuiColours * tuiColours; p++) {
+        int fg = p % tuiColours, bg = p / tuiColours;
+        init_pair((short)p,
+                  (short)(tuiColourMap[fg & 7] + (fg & 8)),
+                  (short)(tuiColourMap[bg & 7] + (bg & 8)));
+    }
+}
+
+static chtype disptuiAttr(uint8_t attr) {
+    int fg = attr & 0x0F, bg = attr >> 4;
+    if (tuiColours == 16) return COLOR_PAIR(bg * 16 + fg);
+    if (tuiColours == 8)
+        return COLOR_PAIR((bg & 7) * 8 + (fg & 7)) | (fg & 8 ? A_BOLD : 0);
+    return bg > fg ? A_REVERSE : A_NORMAL;
+}
+
+// Character-RAM glyph → terminal character: the ASCII character whose
+// built-in glyph it is, else one by how much of the cell is ink
+static chtype disptuiMatch(const uint8_t *g) {
+    static const char ramp[] = ".:+*#";
+    for (int c = ' '; c < 127; c++)
+        if (memcmp(g, tuiBuiltin[c], DISPGFX_CHAR_H) == 0) return (chtype)c;
+    int ink = 0;
+    for (int y = 0; y < DISPGFX_CHAR_H; y++)
+        for (uint8_t b = g[y]; b; b &= (uint8_t)(b - 1)) ink++;
+    if (ink == 64) return ACS_BLOCK;
+    return (chtype)ramp[(ink - 1) * 5 / 63];
+}
+
+// Refresh tuiGlyph for the frame's font; glyphs whose terminal character
+// changed get tuiGlyphDirty, so the cells showing them are rewritten
+static int disptuiGlyphs(const dispgfx_frame_t *f) {
+    int any = 0;
+    memset(tuiGlyphDirty, 0, sizeof(tuiGlyphDirty));
+    if (f->hasCharRam == tuiCharRam &&
+        (!f->hasCharRam || memcmp(f->charRam, tuiFont, sizeof(tuiFont)) == 0))
+        return 0;
+
+    for (int g = 0; g < DISPGFX_GLYPHS; g++) {
+        chtype c;
+        if (f->hasCharRam) {
+            if (tuiCharRam == 1 &&
+                memcmp(f->charRam[g], tuiFont[g], DISPGFX_CHAR_H) == 0)
+                continue;
+            memcpy(tuiFont[g], f->charRam[g], DISPGFX_CHAR_H);
+            tuiStats.glyphs++;
+            c = disptuiMatch(f->charRam[g]);
+        } else {
+            // Built-in font: 0-31, 127 and 128-255 are blank
+            c = g > ' ' && g < 127 ? (chtype)g : ' ';
+        }
+        if (c != tuiGlyph[g]) {
+            tuiGlyph[g] = c;
+            tuiGlyphDirty[g] = 1;
+            any = 1;
+        }
+    }
+    tuiCharRam = f->hasCharRam;
+    return any;
+}
+
+static void disptuiPut(int row, int col, chtype c, uint8_t attr) {
+    // Same colour both sides: the glyph cannot show, a space is cheaper
+    if ((attr & 0x0F) == attr >> 4) c = ' ';
+    mvaddch(row, col, c | disptuiAttr(attr));
+    tuiStats.cells++;
+}
+
+static void disptuiText(const dispgfx_frame_t *f) {
+    int anyGlyph = disptuiGlyphs(f);
+    for (int row = 0; row < f->rows; row++) {
+        int base = row * f->cols;
+        if (tuiValid && !anyGlyph &&
+            memcmp(&f->vram[base], &tuiVram[base], (size_t)f->cols) == 0 &&
+            memcmp(&f->cram[base], &tuiCram[base], (size_t)f->cols) == 0)
+            continue;
+        for (int col = 0; col < f->cols; col++) {
+            int i = base + col;
+            uint8_t ch = f->vram[i], attr = f->cram[i];
+            if (tuiValid && ch == tuiVram[i] && attr == tuiCram[i] &&
+                !tuiGlyphDirty[ch])
+                continue;
+            disptuiPut(row, col, tuiGlyph[ch], attr);
+            tuiVram[i] = ch;
+            tuiCram[i] = attr;
+        }
+    }
+    tuiValid = 1;
+}
+
+// Bitmap mode: one terminal cell per 8×8 block, in its most common colour
+static void disptuiBitmap(const dispgfx_frame_t *f) {
+    for (int row = 0; row < DISPGFX_ROWS; row++) {
+        for (int col = 0; col < DISPGFX_COLS; col++) {
+            int count[DISPGFX_NUM_COLOURS] = {0};
+            const uint8_t *src = &f->bitmap[row * DISPGFX_CHAR_H *
+                                            DISPGFX_BITMAP_PITCH + col * 4];
+            for (int y = 0; y < DISPGFX_CHAR_H; y++, src += DISPGFX_BITMAP_PITCH)
+                for (int x = 0; x < 4; x++) {
+                    count[src[x] >> 4]++;
+                    count[src[x] & 0x0F]++;
+                }
+            uint8_t best = 0;
+            for (int c = 1; c < DISPGFX_NUM_COLOURS; c++)
+                if (count[c] > count[best]) best = (uint8_t)c;
+
+            int i = row * DISPGFX_COLS + col;
+            if (tuiValid && tuiCram[i] == best) continue;
+            disptuiPut(row, col, ' ', (uint8_t)(best << 4 | best));
+            tuiCram[i] = best;
+        }
+    }
+    tuiValid = 1;
+}
+
+void disptuiFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c) {
+    tuiStats.frames++;
+
+    // New mode or geometry: start from a blank terminal
+    int cols = f->mode == DISPGFX_MODE_BITMAP ? DISPGFX_COLS : f->cols;
+    int rows = f->mode == DISPGFX_MODE_BITMAP ? DISPGFX_ROWS : f->rows;
+    if (f->mode != tuiMode || cols != tuiCols || rows != tuiRows) {
+        tuiMode = f->mode;
+        tuiCols = cols;
+        tuiRows = rows;
+        tuiValid = 0;
+        erase();
+    }
+
+    int cursorIdx = -1;
+    if (f->mode == DISPGFX_MODE_BITMAP) {
+        disptuiBitmap(f);
+    } else if (!f->hasVram) {
+        // No VRAM base yet: blank, like the window
+        if (tuiValid) erase();
+        tuiValid = 0;
+    } else {
+        disptuiText(f);
+        if (c->on && c->col < f->cols && c->row < f->rows)
+            cursorIdx = c->row * f->cols + c->col;
+    }
+
+    if (cursorIdx != tuiCursor) {
+        curs_set(cursorIdx >= 0);
+        tuiCursor = cursorIdx;
+    }
+    if (cursorIdx >= 0) move(cursorIdx / cols, cursorIdx % cols);
+    refresh();
+}
+
+// Terminal resized: curses only learns of it through getch(), which the
+// keyboard device's reads would race with, so ask the tty directly
+void disptuiCheckSize(void) {
+#ifdef TIOCGWINSZ
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) < 0 || !ws.ws_row) return;
+    if (ws.ws_row == LINES && ws.ws_col == COLS) return;
+    resizeterm(ws.ws_row, ws.ws_col);
+    clearok(stdscr, TRUE);
+    tuiValid = 0;
+#endif
+}
+
+void disptuiCleanup(void) {
+    endwin();
+    fprintf(stderr,
+            "[DISPGFX] terminal: %llu frames, %.1f cells written per "
+            "frame, %s colour\n",
+            (unsigned long long)tuiStats.frames,
+            tuiStats.frames ? (double)tuiStats.cells /
+                                  (double)tuiStats.frames
+                            : 0.0,
+            tuiColours == 16 ? "16" : tuiColours == 8 ? "8" : "no");
+    if (tuiStats.glyphs)
+        fprintf(stderr, "[DISPGFX] %llu character-RAM glyphs redefined\n",
+                (unsigned long long)tuiStats.glyphs);
+}
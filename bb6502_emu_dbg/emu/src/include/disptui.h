@@ -0,0 +1,21 @@
+#pragma once
+
+#include "dispgfx.h"
+#include <stdint.h>
+
+// ─── Terminal backend (-u tui, disptui.c) ────────────────────────────────────
+// Draws captured frames with curses; dispgfx.c runs the 60 Hz loop on the
+// main thread and keeps the device state. Only output goes through curses.
+
+// Take over the terminal. `font` is the built-in font in ASCII order, used
+// to map character-RAM glyphs back to the characters they copy.
+extern void disptuiInit(const uint8_t (*font)[DISPGFX_CHAR_H]);
+
+// Write the cells that changed since the last call (front frame locked)
+extern void disptuiFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c);
+
+// Follow a terminal resize; the next frame rewrites every cell
+extern void disptuiCheckSize(void);
+
+// Give the terminal back and print the totals
+extern void disptuiCleanup(void);
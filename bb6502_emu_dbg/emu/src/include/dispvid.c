@@ -0,0 +1,232 @@
+// dispvid.c — Video recording for dispgfx (--record-video, format in
+// dispvid.h)
+//
+// Runs after each frame is rendered (raster thread, terminal loop, or
+// dispgfxFrameTick when headless) and diffs the front frame against the
+// state the log describes so far, so a frame costs a compare of its cells
+// and the log grows only by what changed.
+
+#include "dispvid.h"
+
+#ifdef _MSC_VER
+#include <SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static FILE       *recFile    = NULL;
+static const char *recPath    = NULL;
+static uint8_t     recBuf[1 << 16];    // one frame record
+static int         recLen     = 0;
+static int         recMode    = -1;    // -1 = nothing recorded yet
+static int         recCursor  = -1;
+static int         recCharRam = 0;
+static uint8_t     recScroll  = 0;
+static uint8_t     recVram[DISPGFX_VRAM_MAX];
+static uint8_t     recCram[DISPGFX_VRAM_MAX];
+static uint8_t     recFont[DISPGFX_GLYPHS][DISPGFX_CHAR_H];
+static uint8_t     recBitmap[DISPGFX_BITMAP_SIZE];
+static uint64_t    recFrames  = 0;
+static uint64_t    recBytes   = 0;
+static uint64_t    recCalls   = 0;
+static double      recUs      = 0;
+
+static void dispvidByte(uint8_t b) { recBuf[recLen++] = b; }
+
+static void dispvidWord(uint16_t w) {
+    recBuf[recLen++] = (uint8_t)w;
+    recBuf[recLen++] = (uint8_t)(w >> 8);
+}
+
+static void dispvidBytes(const uint8_t *p, int n) {
+    memcpy(&recBuf[recLen], p, (size_t)n);
+    recLen += n;
+}
+
+int dispvidOpen(const char *path, const uint32_t *palette,
+                const uint8_t (*font)[DISPGFX_CHAR_H]) {
+    recFile = fopen(path, "wb");
+    if (!recFile) {
+        fprintf(stderr, "[DISPGFX] cannot write %s: ", path);
+        perror("fopen(): ");
+        return -1;
+    }
+    recPath = path;
+    setvbuf(recFile, NULL, _IOFBF, 1 << 16);
+    recLen = 0;
+    dispvidBytes((const uint8_t *)DISPVID_MAGIC, 8);
+    for (int i = 0; i < DISPGFX_NUM_COLOURS; i++) {
+        dispvidWord((uint16_t)palette[i]);
+        dispvidWord((uint16_t)(palette[i] >> 16));
+    }
+    dispvidBytes(&font[0][0], 128 * DISPGFX_CHAR_H);   // ASCII 0-127
+    fwrite(recBuf, 1, (size_t)recLen, recFile);
+    recBytes += (uint64_t)recLen;
+    return 0;
+}
+
+// Scroll the recorded screen the way the ring moved since the last frame,
+// so a hardware scroll costs one op instead of a screenful of cells
+static void dispvidScroll(const dispgfx_frame_t *f) {
+    int cols = f->cols, rows = f->rows;
+    int d = (f->scroll - recScroll + rows) % rows;
+    recScroll = f->scroll;
+    if (d == 0) return;
+
+    int n = d <= rows / 2 ? d : d - rows;   // rows up, negative = down
+    size_t keep = (size_t)((rows - (n > 0 ? n : -n)) * cols);
+    size_t gone = (size_t)(rows * cols) - keep;
+    if (n > 0) {
+        memmove(recVram, recVram + gone, keep);
+        memmove(recCram, recCram + gone, keep);
+        memset(recVram + keep, 0, gone);
+        memset(recCram + keep, 0, gone);
+    } else {
+        memmove(recVram + gone, recVram, keep);
+        memmove(recCram + gone, recCram, keep);
+        memset(recVram, 0, gone);
+        memset(recCram, 0, gone);
+    }
+    dispvidByte(DISPVID_SCROLL);
+    dispvidByte((uint8_t)(int8_t)n);
+}
+
+static void dispvidText(const dispgfx_frame_t *f) {
+    static const uint8_t zeros[DISPGFX_VRAM_MAX];
+    const uint8_t *vram = f->hasVram ? f->vram : zeros;
+    const uint8_t *cram = f->hasVram ? f->cram : zeros;
+    int cells = f->cols * f->rows;
+
+    if (f->hasVram) dispvidScroll(f);
+
+    if (f->hasCharRam != recCharRam) {
+        recCharRam = f->hasCharRam;
+        dispvidByte(DISPVID_FONT);
+        dispvidByte((uint8_t)recCharRam);
+    }
+    for (int g = 0; f->hasCharRam && g < DISPGFX_GLYPHS;) {
+        if (memcmp(f->charRam[g], recFont[g], DISPGFX_CHAR_H) == 0) {
+            g++;
+            continue;
+        }
+        int n = 1;
+        while (g + n < DISPGFX_GLYPHS && n < 255 &&
+               memcmp(f->charRam[g + n], recFont[g + n], DISPGFX_CHAR_H) != 0)
+            n++;
+        dispvidByte(DISPVID_GLYPHS);
+        dispvidByte((uint8_t)g);
+        dispvidByte((uint8_t)n);
+        dispvidBytes(f->charRam[g], n * DISPGFX_CHAR_H);
+        memcpy(recFont[g], f->charRam[g], (size_t)n * DISPGFX_CHAR_H);
+        g += n;
+    }
+
+    // Runs of changed cells; a single unchanged cell inside a run is
+    // cheaper to repeat than to start a new run
+#define CELL_DIFF(i) (vram[i] != recVram[i] || cram[i] != recCram[i])
+    for (int i = 0; i < cells;) {
+        if (!CELL_DIFF(i)) {
+            i++;
+            continue;
+        }
+        int j = i + 1;
+        while (j < cells && j - i < 255) {
+            if (CELL_DIFF(j)) {
+                j++;
+            } else if (j + 1 < cells && j + 1 - i < 255 && CELL_DIFF(j + 1)) {
+                j += 2;
+            } else {
+                break;
+            }
+        }
+        dispvidByte(DISPVID_CELLS);
+        dispvidWord((uint16_t)i);
+        dispvidByte((uint8_t)(j - i));
+        for (int k = i; k < j; k++) {
+            dispvidByte(vram[k]);
+            dispvidByte(cram[k]);
+            recVram[k] = vram[k];
+            recCram[k] = cram[k];
+        }
+        i = j;
+    }
+#undef CELL_DIFF
+}
+
+static void dispvidBitmap(const dispgfx_frame_t *f) {
+    const int band = DISPGFX_CHAR_H * DISPGFX_BITMAP_PITCH;
+    for (int b = 0; b < DISPGFX_ROWS; b++) {
+        if (memcmp(&f->bitmap[b * band], &recBitmap[b * band], band) == 0)
+            continue;
+        dispvidByte(DISPVID_BAND);
+        dispvidByte((uint8_t)b);
+        dispvidBytes(&f->bitmap[b * band], band);
+        memcpy(&recBitmap[b * band], &f->bitmap[b * band], band);
+    }
+}
+
+void dispvidFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c,
+                  uint32_t frame) {
+    uint64_t t0 = SDL_GetPerformanceCounter();
+
+    recLen = 0;
+    dispvidByte(DISPVID_FRAME);
+    dispvidWord((uint16_t)frame);
+    dispvidWord((uint16_t)(frame >> 16));
+    dispvidByte((uint8_t)f->mode);
+    int cursorAt = recLen;
+    dispvidWord(0xFFFF);
+    int header = recLen;
+
+    int changed = f->mode != recMode;
+    if (changed) {
+        recMode = f->mode;
+        recCharRam = 0;
+        recScroll = f->scroll;
+        memset(recVram, 0, sizeof(recVram));
+        memset(recCram, 0, sizeof(recCram));
+        memset(recFont, 0, sizeof(recFont));
+        memset(recBitmap, 0, sizeof(recBitmap));
+    }
+
+    int cursorIdx = -1;
+    if (f->mode == DISPGFX_MODE_BITMAP) {
+        dispvidBitmap(f);
+    } else {
+        // Same blink phase as the renderer: toggles every 30 frames
+        if (f->hasVram && c->on && ((frame / 30) & 1) &&
+            c->col < f->cols && c->row < f->rows)
+            cursorIdx = c->row * f->cols + c->col;
+        dispvidText(f);
+    }
+
+    if (cursorIdx != recCursor) changed = 1;
+    recCursor = cursorIdx;
+    recBuf[cursorAt]     = (uint8_t)cursorIdx;
+    recBuf[cursorAt + 1] = (uint8_t)(cursorIdx >> 8);
+
+    if (changed || recLen > header) {
+        dispvidByte(DISPVID_END);
+        fwrite(recBuf, 1, (size_t)recLen, recFile);
+        recBytes += (uint64_t)recLen;
+        recFrames++;
+    }
+    recCalls++;
+    recUs += (double)(SDL_GetPerformanceCounter() - t0) * 1e6 /
+             (double)SDL_GetPerformanceFrequency();
+}
+
+void dispvidClose(void) {
+    fclose(recFile);
+    recFile = NULL;
+    fprintf(stderr,
+            "[DISPGFX] video: %llu of %llu frames recorded to %s, "
+            "%.1f KB, %.1f us per frame\n",
+            (unsigned long long)recFrames, (unsigned long long)recCalls,
+            recPath, (double)recBytes / 1024.0,
+            recCalls ? recUs / (double)recCalls : 0.0);
+}
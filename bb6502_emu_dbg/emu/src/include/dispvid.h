@@ -0,0 +1,53 @@
+#pragma once
+
+// ─── dispgfx video log (--record-video) ─────────────────────────────────────
+// Written by dispvid.c, expanded to pixels by tools/bbvid.c. Records what
+// the display showed as cell changes, not pixels. All integers little
+// endian.
+//
+// Header
+//   8 bytes   DISPVID_MAGIC
+//   64 bytes  palette: 16 × u32 ARGB8888
+//   1024      built-in font: 128 glyphs × 8 rows, MSB leftmost
+//
+// Frame record, one per frame in which anything on screen changed:
+//   u8  DISPVID_FRAME
+//   u32 frame number (60 Hz ticks since start; gaps = unchanged frames)
+//   u8  DISPGFX_MODE_*
+//   u16 cursor cell shown inverted, 0xFFFF = none
+//   ops, then u8 DISPVID_END
+//
+// Ops apply in order to the state left by the previous frame:
+//   DISPVID_SCROLL  i8 rows       move the text screen up (> 0) or down
+//                                 (< 0); rows coming into view are zero
+//   DISPVID_FONT    u8 source     0 = built-in font, 1 = character RAM
+//   DISPVID_GLYPHS  u8 first, u8 count, count × 8 bytes: character RAM
+//   DISPVID_CELLS   u16 first cell, u8 count, count × (char, attr)
+//   DISPVID_BAND    u8 band, 1280 bytes: 8 bitmap rows (4 bpp, 160/row)
+//
+// A mode change resets every cell (char 0, attr 0: black), the bitmap and
+// the character RAM to zero before the ops of that frame.
+
+#include "dispgfx.h"
+#include <stdint.h>
+
+#define DISPVID_MAGIC   "BB6502V1"
+
+#define DISPVID_FRAME   'F'
+#define DISPVID_END     'E'
+#define DISPVID_SCROLL  'S'
+#define DISPVID_FONT    'T'
+#define DISPVID_GLYPHS  'G'
+#define DISPVID_CELLS   'C'
+#define DISPVID_BAND    'B'
+
+// ─── Recorder (dispvid.c, driven by dispgfx.c) ──────────────────────────────
+// Open writes the header (the built-in font is glyphs 0-127 of `font`) and
+// returns 0, or -1 if the file can't be created. Frame appends one record
+// if anything changed; it is called with the front frame locked. Close
+// prints the totals.
+extern int  dispvidOpen(const char *path, const uint32_t *palette,
+                        const uint8_t (*font)[DISPGFX_CHAR_H]);
+extern void dispvidFrame(const dispgfx_frame_t *f, const dispgfx_cursor_t *c,
+                         uint32_t frame);
+extern void dispvidClose(void);
@@ -1,19 +1,32 @@
 #include <string.h>
 #include "fake6502.h"
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <signal.h>
 
 void dbgParseCmdLineArgs(int argc, char **argv);
 
 // Variables
-static char dbgCmdBuf[100], *dbgBinFileName, *dbgSrcFileName, *dbgFloppyFile;
+static char dbgCmdBuf[100], *dbgBinFileName, *dbgSrcFileName;
+static char *dbgFloppyFiles[FLOPPY_MAX_DRIVES];
+static int dbgNofFloppyFiles;
 #define MAX_SYM_FILES 16
 static char *dbgSymFileNames[MAX_SYM_FILES];
 static int dbgNofSymFiles;
-static int dbgUiType; 
+static int dbgUiType; // 0 = SDL window (gui), 1 = terminal (tui)
+static int dbgFloppyReadOnly;
+static char *dbgOverlayFiles[FLOPPY_MAX_DRIVES];
+static char *dbgTimingModel;
+static int dbgNoTrackCache;
+static char *dbgHddFile;
+static unsigned long dbgHddSizeMiB; // 0 = HDD_DEFAULT_CAPACITY
+static int dbgHeadless;
+static char *dbgTextOutFile;
+static unsigned long long dbgMaxCycles; // 0 = run until stopped
 
 
 // ─── CPU state
@@ -33,6 +46,8 @@ pthread_mutex_t kbdLock = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t kbdCond = PTHREAD_COND_INITIALIZER;
 pthread_mutex_t floppyLock = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t floppyCond = PTHREAD_COND_INITIALIZER;
+pthread_mutex_t hddLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t hddCond = PTHREAD_COND_INITIALIZER;
 pthread_mutex_t disptextLock = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t disptextCond = PTHREAD_COND_INITIALIZER;
 pthread_mutex_t dispgfxLock = PTHREAD_MUTEX_INITIALIZER;
@@ -46,6 +61,13 @@ volatile int devicesReady = 0;
 // volatile alone does not guarantee visibility across cores on ARM (Apple
 // Silicon).
 volatile _Atomic int irqPending = 0;
+volatile _Atomic uint32_t cpuCycles = 0;
+
+// One flag per 256-byte page: set for pages holding a device register.
+// Bulk DMA checks mmioRegs byte by byte on these pages only.
+static uint8_t mmioPages[256];
+// One bit per address: set for every device register byte
+static uint8_t mmioRegs[0x10000 / 8];
 
 #define pthrd_lock_all()                                                       \
   do {                                                                         \
@@ -53,6 +75,7 @@ volatile _Atomic int irqPending = 0;
     pthread_mutex_lock(&disptextLock);                                         \
     pthread_mutex_lock(&floppyLock);                                           \
     pthread_mutex_lock(&dispgfxLock);                                          \
+    pthread_mutex_lock(&hddLock);                                              \
   } while (0);
 
 #define pthrd_unlock_all()                                                     \
@@ -61,6 +84,7 @@ volatile _Atomic int irqPending = 0;
     pthread_mutex_unlock(&disptextLock);                                       \
     pthread_mutex_unlock(&floppyLock);                                         \
     pthread_mutex_unlock(&dispgfxLock);                                        \
+    pthread_mutex_unlock(&hddLock);                                            \
   } while (0);
 
 // ─── MMIO dispatch
@@ -71,9 +95,11 @@ volatile _Atomic int irqPending = 0;
 
 uint8_t read6502(uint16_t address) {
   if (devicesReady) {
-    // Floppy registers
+    // Floppy registers (STATUS/CMD mirror the selected drive)
     if (address == floppyStatusRegAddr || address == floppyCmdRegAddr ||
-        address == floppyDataRegAddr) {
+        address == floppyDataRegAddr ||
+        (floppyDriveRegAddr && (address == floppyDriveRegAddr ||
+                                address == (uint16_t)(floppyDriveRegAddr + 1)))) {
       pthread_mutex_lock(&floppyLock);
       uint8_t v = mem6502[address];
       pthread_mutex_unlock(&floppyLock);
@@ -91,25 +117,39 @@ uint8_t read6502(uint16_t address) {
         address == dispgfxDataRegAddr ||
         address == (uint16_t)(dispgfxDataRegAddr + 1)) {
       pthread_mutex_lock(&dispgfxLock);
-      uint8_t v = mem6502[address];
+      uint8_t v = address == dispgfxStatusRegAddr ? dispgfxStatusRead()
+                                                  : mem6502[address];
       pthread_mutex_unlock(&dispgfxLock);
       return v;
     }
+    // Hard disk registers (DATA is plain memory, handed over by CMD)
+    if (hddCmdRegAddr &&
+        (address == hddStatusRegAddr || address == hddCmdRegAddr)) {
+      pthread_mutex_lock(&hddLock);
+      uint8_t v = mem6502[address];
+      pthread_mutex_unlock(&hddLock);
+      return v;
+    }
+    // Timer registers: CPU thread only, no lock
+    if (timerCtrlRegAddr && (uint16_t)(address - timerCtrlRegAddr) < 4) {
+      return timerRegRead(address);
+    }
+    // Interrupt controller registers (atomics, no lock)
+    if (irqcPendingRegAddr && (uint16_t)(address - irqcPendingRegAddr) < 4) {
+      return irqcRegRead(address);
+    }
   }
   return mem6502[address];
 }
 
 void write6502(uint16_t address, uint8_t value) {
   if (devicesReady) {
-    // Floppy registers
+    // Floppy registers: routed to the selected drive
     if (address == floppyCmdRegAddr || address == floppyStatusRegAddr ||
-        address == floppyDataRegAddr) {
-      pthread_mutex_lock(&floppyLock);
-      mem6502[address] = value;
-      if (value != FLOPPY_CMD_NO_CMD) {
-        pthread_cond_signal(&floppyCond);
-      }
-      pthread_mutex_unlock(&floppyLock);
+        address == floppyDataRegAddr ||
+        (floppyDriveRegAddr && (address == floppyDriveRegAddr ||
+                                address == (uint16_t)(floppyDriveRegAddr + 1)))) {
+      floppyRegWrite(address, value);
       return;
     }
     // Disptext single data register
@@ -136,10 +176,87 @@ void write6502(uint16_t address, uint8_t value) {
       pthread_mutex_unlock(&dispgfxLock);
       return;
     }
+    // Hard disk registers
+    if (hddCmdRegAddr &&
+        (address == hddStatusRegAddr || address == hddCmdRegAddr)) {
+      pthread_mutex_lock(&hddLock);
+      mem6502[address] = value;
+      if (address == hddCmdRegAddr && value != HDD_CMD_NO_CMD) {
+        pthread_cond_signal(&hddCond);
+      }
+      pthread_mutex_unlock(&hddLock);
+      return;
+    }
+    // Timer registers
+    if (timerCtrlRegAddr && (uint16_t)(address - timerCtrlRegAddr) < 4) {
+      timerRegWrite(address, value);
+      return;
+    }
+    // Interrupt controller registers
+    if (irqcPendingRegAddr && (uint16_t)(address - irqcPendingRegAddr) < 4) {
+      irqcRegWrite(address, value);
+      return;
+    }
   }
   mem6502[address] = value;
 }
 
+// ─── Bulk DMA
+// ──────────────────────────────────────────────────────────────── Device DMA
+// engines copy whole pages with memcpy instead of one write6502/read6502 per
+// byte. The 16-bit DMA address wraps at $FFFF like the CPU's own address bus.
+// DMA runs on the device threads, and the timer and IRQC handlers are
+// CPU-thread only, so DMA never reaches a register handler: device registers
+// inside the range are skipped on write and read back as $FF.
+
+static void mmioMarkRegister(uint16_t address) {
+  mmioPages[address >> 8] = 1;
+  mmioRegs[address >> 3] |= (uint8_t)(1u << (address & 7));
+}
+
+static int mmioIsRegister(uint16_t address) {
+  return mmioRegs[address >> 3] & (1u << (address & 7));
+}
+
+void dma6502Write(uint16_t address, const uint8_t *src, uint32_t len) {
+  while (len) {
+    uint32_t chunk = 0x100 - (address & 0xFF);
+    if (chunk > len)
+      chunk = len;
+    if (devicesReady && mmioPages[address >> 8]) {
+      for (uint32_t i = 0; i < chunk; i++) {
+        uint16_t a = (uint16_t)(address + i);
+        if (!mmioIsRegister(a))
+          mem6502[a] = src[i];
+      }
+    } else {
+      memcpy(&mem6502[address], src, chunk);
+    }
+    address = (uint16_t)(address + chunk);
+    src += chunk;
+    len -= chunk;
+  }
+}
+
+void dma6502Read(uint16_t address, uint8_t *dst, uint32_t len) {
+  while (len) {
+    uint32_t chunk = 0x100 - (address & 0xFF);
+    if (chunk > len)
+      chunk = len;
+    if (devicesReady && mmioPages[address >> 8]) {
+      for (uint32_t i = 0; i < chunk; i++) {
+        uint16_t a = (uint16_t)(address + i);
+        dst[i] = mmioIsRegister(a) ? 0xFF : mem6502[a];
+      }
+    } else {
+      memcpy(dst, &mem6502[address], chunk);
+    }
+    address = (uint16_t)(address + chunk);
+    dst += chunk;
+    len -= chunk;
+  }
+}
+
 // addressing mode functions, calculates effective addresses
 static void imp(void);
 static void acc(void);
@@ -1057,24 +1174,60 @@ void hookexternal(void *funcptr) {
 // ─── CPU thread entry point ─────────────────────────────────────────────────
 // SDL2 on macOS requires the event/render loop on the main thread,
 // so the CPU runs on its own pthread instead.
+// Headless runs it on the main thread instead, and drives dispgfx frames
+// from the cycle count since there is no render loop.
+#define EMU_FRAME_CYCLES (EMU_CPU_HZ / 60)
+
 static void *cpuLoop(void *arg) {
   (void)arg;
+  uint32_t nextFrame = EMU_FRAME_CYCLES, last = 0;
+  unsigned long long total = 0;
   reset6502();
   while (running) {
     if (irqPending && !(status & FLAG_INTERRUPT)) {
+      // irqPending only says "look at the line". The controller's line is
+      // a level: the flag stays up while it is asserted, so a handler that
+      // returns with an unmasked source still pending is entered again.
+      // Without the controller each raise is one IRQ.
       irqPending = 0;
-      irq6502();
+      if (irqcLineActive()) {
+        irqPending = 1;
+        irq6502();
+      } else if (!irqcPendingRegAddr) {
+        irq6502();
+      }
     }
     step6502();
+    timerTick(clockticks6502);
+    // Relaxed: a plain store on every host we target, no fence per opcode
+    atomic_store_explicit(&cpuCycles, clockticks6502, memory_order_relaxed);
+
+    if (dbgHeadless || dbgMaxCycles) {
+      if (dbgHeadless && (int32_t)(clockticks6502 - nextFrame) >= 0) {
+        nextFrame += EMU_FRAME_CYCLES;
+        dispgfxFrameTick();
+      }
+      total += clockticks6502 - last;
+      last = clockticks6502;
+      if (dbgMaxCycles && total >= dbgMaxCycles)
+        running = 0;
+    }
   }
   return NULL;
 }
 
+static void onStopSignal(int sig) {
+  (void)sig;
+  running = 0;
+}
+
 void fake6502Init(int argc, char **argv) {
   memset(dbgCmdBuf, 0, sizeof(dbgCmdBuf));
   dbgBinFileName = NULL;
   dbgSrcFileName = NULL;
-  dbgFloppyFile = NULL;
+  memset(dbgFloppyFiles, 0, sizeof(dbgFloppyFiles));
+  memset(dbgOverlayFiles, 0, sizeof(dbgOverlayFiles));
+  dbgNofFloppyFiles = 0;
   dbgNofSymFiles = 0;
   memset(dbgSymFileNames, 0, sizeof(dbgSymFileNames));
   dbgParseCmdLineArgs(argc, argv);
@@ -1112,38 +1265,121 @@ void fake6502Init(int argc, char **argv) {
   fclose(f);
 
   // ── Optional floppy image ─────────────────────────────────────────────────
-  if (dbgFloppyFile) {
-    snprintf(flpFileName, sizeof(flpFileName), "%s", dbgFloppyFile);
+  // One drive per -f, A: first; A: is always attached
+  flpDriveCount = dbgNofFloppyFiles > 0 ? dbgNofFloppyFiles : 1;
+  for (int i = 0; i < flpDriveCount; i++) {
+    if (dbgFloppyFiles[i]) {
+      snprintf(flpFileName[i], sizeof(flpFileName[i]), "%s", dbgFloppyFiles[i]);
+    }
+    if (dbgOverlayFiles[i]) {
+      snprintf(flpOverlayFileName[i], sizeof(flpOverlayFileName[i]), "%s",
+               dbgOverlayFiles[i]);
+    }
+  }
+  flpReadOnly = dbgFloppyReadOnly;
+  if (dbgTimingModel && floppySetTimingModel(dbgTimingModel) < 0) {
+    fprintf(stderr, "Invalid option for arg -t: %s\n", dbgTimingModel);
+    fprintf(stderr, "Defaulting to realistic\n");
+  }
+  flpTrackCache = !dbgNoTrackCache;
+  if (dbgHddFile) {
+    snprintf(hddFileName, sizeof(hddFileName), "%s", dbgHddFile);
+  }
+  if (dbgHddSizeMiB) {
+    hddCreateSize = (uint64_t)dbgHddSizeMiB << 20;
+  }
+  if (dbgTextOutFile) {
+    disptextOut = fopen(dbgTextOutFile, "w");
+    if (!disptextOut) {
+      fprintf(stderr, "Failed to open text output file::");
+      perror("fopen(): ");
+      exit(1);
+    }
+  }
+  dispgfxHeadless = dbgHeadless;
+  if (dbgUiType == 1 && dbgHeadless) {
+    fprintf(stderr, "[WARN] -u tui ignored with --headless\n");
+  } else if (dbgUiType == 1) {
+    // The terminal belongs to the display: text output only via --text-out
+    dispgfxTui = 1;
+    disptextQuiet = !dbgTextOutFile;
   }
 
   // ── Start device threads ──────────────────────────────────────────────────
-  kbdInit();
+  irqcInit();              // first: devices may raise IRQs as they start
   floppyInit();
+  hddInit();
+  timerInit();
   disptextInit();
   dispgfxInit();           // creates SDL window — must be on main thread
+                           // (unless headless)
+  kbdInit();               // after dispgfxInit: -u tui's curses setup
+                           // must not replace the raw terminal mode
+
+  // Registers that bulk DMA must leave alone (see dma6502Write)
+  mmioMarkRegister(floppyStatusRegAddr);
+  mmioMarkRegister(floppyCmdRegAddr);
+  mmioMarkRegister(floppyDataRegAddr);
+  if (floppyDriveRegAddr) {
+    mmioMarkRegister(floppyDriveRegAddr);
+    mmioMarkRegister((uint16_t)(floppyDriveRegAddr + 1));
+  }
+  mmioMarkRegister(disptextDataRegAddr);
+  mmioMarkRegister(dispgfxCmdRegAddr);
+  mmioMarkRegister(dispgfxDataRegAddr);
+  mmioMarkRegister((uint16_t)(dispgfxDataRegAddr + 1));
+  mmioMarkRegister(dispgfxStatusRegAddr);
+  if (hddCmdRegAddr) {
+    mmioMarkRegister(hddStatusRegAddr);
+    mmioMarkRegister(hddCmdRegAddr);
+  }
+  for (int i = 0; i < 4; i++) {
+    if (timerCtrlRegAddr)
+      mmioMarkRegister((uint16_t)(timerCtrlRegAddr + i));
+    if (irqcPendingRegAddr)
+      mmioMarkRegister((uint16_t)(irqcPendingRegAddr + i));
+  }
 
   // Gate MMIO interception: from here on, read6502/write6502 will
   // route accesses to device registers through the appropriate locks.
   devicesReady = 1;
 
-  // ── Spawn CPU on its own pthread ──────────────────────────────────────────
-  // SDL2 on macOS requires the event+render loop on the main thread,
-  // so the CPU loop moves to a worker thread.
   pthread_t cpuThread;
-  pthread_create(&cpuThread, NULL, cpuLoop, NULL);
+  if (dbgHeadless) {
+    // ── Headless: no render loop, the CPU runs right here ────────────────────
+    // Blocks until --cycles is reached or SIGINT/SIGTERM.
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+    cpuLoop(NULL);
+  } else {
+    // ── Spawn CPU on its own pthread ─────────────────────────────────────────
+    // SDL2 on macOS requires the event+render loop on the main thread,
+    // so the CPU loop moves to a worker thread.
+    pthread_create(&cpuThread, NULL, cpuLoop, NULL);
+
+    // Curses owns the terminal: stop through the teardown so it is restored
+    if (dispgfxTui) {
+      signal(SIGINT, onStopSignal);
+      signal(SIGTERM, onStopSignal);
+    }
 
-  // ── Main thread becomes the SDL render loop ───────────────────────────────
-  // Blocks here until SDL_QUIT or running == 0.
-  dispgfxRenderLoop();
+    // ── Main thread becomes the SDL render loop ──────────────────────────────
+    // Blocks here until SDL_QUIT or running == 0.
+    dispgfxRenderLoop();
+  }
 
   // ── Teardown ──────────────────────────────────────────────────────────────
   running = 0;
 
   // Wake all sleeping device workers so they can see running == 0 and exit
   pthread_mutex_lock(&floppyLock);
-  pthread_cond_signal(&floppyCond);
+  pthread_cond_broadcast(&floppyCond); // one worker per drive
   pthread_mutex_unlock(&floppyLock);
 
+  pthread_mutex_lock(&hddLock);
+  pthread_cond_signal(&hddCond);
+  pthread_mutex_unlock(&hddLock);
+
   pthread_mutex_lock(&disptextLock);
   pthread_cond_signal(&disptextCond);
   pthread_mutex_unlock(&disptextLock);
@@ -1152,8 +1388,14 @@ void fake6502Init(int argc, char **argv) {
   pthread_cond_signal(&dispgfxCond);
   pthread_mutex_unlock(&dispgfxLock);
 
-  pthread_join(cpuThread, NULL);
+  if (!dbgHeadless)
+    pthread_join(cpuThread, NULL);
+  floppyCleanup();
+  hddCleanup();
   dispgfxCleanup();
+  irqcCleanup();
+  if (disptextOut && disptextOut != stdout)
+    fclose(disptextOut);
 }
 
 void dbgParseCmdLineArgs(int argc, char **argv) {
@@ -1163,8 +1405,28 @@ void dbgParseCmdLineArgs(int argc, char **argv) {
     fprintf(stdout, "\t\t-d <filename>: load debug symbols (ld65 --dbgfile "
                     ".dbg file, repeatable)\n");
     fprintf(stdout, "\t\t-s <filename>: load source code\n");
-    fprintf(stdout, "\t\t-f <filename>: load floppy image\n");
-    fprintf(stdout, "\t\t-u <type[tui/gui]>: interface type\n");
+    fprintf(stdout, "\t\t-f <filename>: load floppy image (repeat for B:, C:, D:)\n");
+    fprintf(stdout, "\t\t-r: open the floppy image read-only\n");
+    fprintf(stdout, "\t\t-o <filename>: copy-on-write overlay for the last -f drive\n");
+    fprintf(stdout, "\t\t-t <instant/realistic/scaled:F>: floppy timing\n");
+    fprintf(stdout, "\t\t-n: disable the floppy track read-ahead buffer\n");
+    fprintf(stdout, "\t\t-H <filename>: attach hard disk image (created if missing)\n");
+    fprintf(stdout, "\t\t--hdd-size <MiB>: size of a newly created -H image "
+                    "(default 4096, sparse)\n");
+    fprintf(stdout, "\t\t-u <type[tui/gui]>: display in a window (gui, "
+                    "default) or the terminal (tui)\n");
+    fprintf(stdout, "\t\t--headless: no window; frames from the cycle count\n");
+    fprintf(stdout, "\t\t--dump <file.ppm>: write the screen at exit "
+                    "(headless)\n");
+    fprintf(stdout, "\t\t--dump-every <N>: also every N frames, as "
+                    "<stem>-<frame>.ppm\n");
+    fprintf(stdout, "\t\t--text-out <filename>: text display output "
+                    "(default stdout)\n");
+    fprintf(stdout, "\t\t--cycles <N>: stop after N CPU cycles\n");
+    fprintf(stdout, "\t\t--record-video <filename>: log every changed "
+                    "frame (tools/bbvid converts it)\n");
+    fprintf(stdout, "\t\t--shm <name>: publish the text screen to shared "
+                    "memory /bb6502-<name> (tools/bbview)\n");
     exit(0);
   }
 
@@ -1172,8 +1434,6 @@ void dbgParseCmdLineArgs(int argc, char **argv) {
 
   if (argc < 3) {
     dbgSrcFileName = NULL;
-    dbgFloppyFile = NULL;
-    dbgUiType = 0;
     return;
   }
 
@@ -1205,22 +1465,129 @@ void dbgParseCmdLineArgs(int argc, char **argv) {
         fprintf(stderr, "Missing argument file: -f <image>\n");
         exit(1);
       }
-      dbgFloppyFile = argv[++i];
+      if (dbgNofFloppyFiles < FLOPPY_MAX_DRIVES) {
+        dbgFloppyFiles[dbgNofFloppyFiles++] = argv[++i];
+      } else {
+        fprintf(stderr, "Too many -f flags (max %d)\n", FLOPPY_MAX_DRIVES);
+        i++;
+      }
+    }
+
+    // Floppy image read-only: guest writes are discarded on exit
+    if (strcmp(argv[i], "-r") == 0) {
+      dbgFloppyReadOnly = 1;
+    }
+
+    // Copy-on-write overlay: the floppy image is only read, writes go here
+    if (strcmp(argv[i], "-o") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument file: -o <overlay>\n");
+        exit(1);
+      }
+      // Applies to the drive named by the preceding -f (A: if none yet)
+      dbgOverlayFiles[dbgNofFloppyFiles > 0 ? dbgNofFloppyFiles - 1 : 0] =
+          argv[++i];
+    }
+
+    // Floppy timing model
+    if (strcmp(argv[i], "-t") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument option: -t <instant/realistic/scaled:F>\n");
+        exit(1);
+      }
+      dbgTimingModel = argv[++i];
+    }
+
+    // Attach hard disk image
+    if (strcmp(argv[i], "-H") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument file: -H <image>\n");
+        exit(1);
+      }
+      dbgHddFile = argv[++i];
+    }
+
+    // Size of a hard disk image that -H has to create
+    if (strcmp(argv[i], "--hdd-size") == 0) {
+      if (i >= argc - 1 || strtoul(argv[i + 1], NULL, 0) == 0 ||
+          strtoul(argv[i + 1], NULL, 0) > (HDD_MAX_CAPACITY >> 20)) {
+        fprintf(stderr, "Missing argument option: --hdd-size <1-4096 MiB>\n");
+        exit(1);
+      }
+      dbgHddSizeMiB = strtoul(argv[++i], NULL, 0);
+    }
+
+    // Every floppy access pays seek and rotation, no track buffer
+    if (strcmp(argv[i], "-n") == 0) {
+      dbgNoTrackCache = 1;
+    }
+
+    // No SDL: batch runs on machines without a display
+    if (strcmp(argv[i], "--headless") == 0) {
+      dbgHeadless = 1;
+    }
+
+    if (strcmp(argv[i], "--dump") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument file: --dump <file.ppm>\n");
+        exit(1);
+      }
+      dispgfxDumpFile = argv[++i];
+    }
+
+    if (strcmp(argv[i], "--dump-every") == 0) {
+      if (i >= argc - 1 || atoi(argv[i + 1]) <= 0) {
+        fprintf(stderr, "Missing argument option: --dump-every <frames>\n");
+        exit(1);
+      }
+      dispgfxDumpEvery = (uint32_t)atoi(argv[++i]);
+    }
+
+    if (strcmp(argv[i], "--text-out") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument file: --text-out <filename>\n");
+        exit(1);
+      }
+      dbgTextOutFile = argv[++i];
+    }
+
+    if (strcmp(argv[i], "--record-video") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument file: --record-video <filename>\n");
+        exit(1);
+      }
+      dispgfxRecordFile = argv[++i];
+    }
+
+    if (strcmp(argv[i], "--shm") == 0) {
+      if (i >= argc - 1 || argv[i + 1][0] == '-') {
+        fprintf(stderr, "Missing argument option: --shm <name>\n");
+        exit(1);
+      }
+      dispgfxShmName = argv[++i];
+    }
+
+    if (strcmp(argv[i], "--cycles") == 0) {
+      if (i >= argc - 1 || strtoull(argv[i + 1], NULL, 0) == 0) {
+        fprintf(stderr, "Missing argument option: --cycles <N>\n");
+        exit(1);
+      }
+      dbgMaxCycles = strtoull(argv[++i], NULL, 0);
     }
 
     // Set ui type
     if (strcmp(argv[i], "-u") == 0) {
       if (i >= argc - 1 || argv[i + 1][0] == '-') {
-        fprintf(stderr, "Missing argument option: -u <TUI/gui>\n");
-        fprintf(stderr, "Defaulting to TUI\n");
+        fprintf(stderr, "Missing argument option: -u <tui/GUI>\n");
+        fprintf(stderr, "Defaulting to GUI\n");
         dbgUiType = 0;
-      } else if (strcmp(argv[i + 1], "gui") == 0) {
-        dbgUiType = 1;
-      } else if (strcmp(argv[i + 1], "tui") == 0) {
+      } else if (strcmp(argv[++i], "gui") == 0) {
         dbgUiType = 0;
+      } else if (strcmp(argv[i], "tui") == 0) {
+        dbgUiType = 1;
       } else {
-        fprintf(stderr, "Invalid option for arg -u: %s\n", argv[i + 1]);
-        fprintf(stderr, "Defaulting to TUI\n");
+        fprintf(stderr, "Invalid option for arg -u: %s\n", argv[i]);
+        fprintf(stderr, "Defaulting to GUI\n");
         dbgUiType = 0;
       }
     }
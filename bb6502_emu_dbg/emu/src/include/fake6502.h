@@ -8,7 +8,10 @@
 #include "dispgfx.h"
 #include "disptext.h"
 #include "floppy.h"
+#include "hdd.h"
+#include "irqc.h"
 #include "kbd.h"
+#include "timer.h"
 
 // ─── Device thread argument structure ────────────────────────────────────────
 typedef struct threadArgs {
@@ -16,7 +19,7 @@ typedef struct threadArgs {
   pthread_cond_t *cond;
 } threadArgs;
 
-// ─── Device table (0xFF00–0xFF0F): 2-byte LE pointers to actual registers ───
+// ─── Device table (0xFF00–0xFF1B): 2-byte LE pointers to actual registers ───
 //     Each entry is the address stored in the table, not the register itself.
 //
 //  $FF00–$FF01  →  address of floppy STATUS reg
@@ -27,6 +30,12 @@ typedef struct threadArgs {
 //  $FF0A–$FF0B  →  address of dispgfx CMD reg
 //  $FF0C–$FF0D  →  address of dispgfx DATA reg
 //  $FF0E–$FF0F  →  address of dispgfx STATUS reg
+//  $FF10–$FF11  →  address of hdd STATUS reg
+//  $FF12–$FF13  →  address of hdd CMD reg
+//  $FF14–$FF15  →  address of hdd DATA reg (4 bytes)
+//  $FF16–$FF17  →  address of floppy DRIVE reg (DRIVE+1 = IRQ pending mask)
+//  $FF18–$FF19  →  address of timer CTRL reg (STATUS, COUNT lo/hi follow)
+//  $FF1A–$FF1B  →  address of irqc PENDING reg (MASK, CAUSE, ACK follow)
 
 #define EMU_FLOPPY_BASE (0xFF00)
 #define EMU_FLOPPY_STATUS_REG (EMU_FLOPPY_BASE + 0)
@@ -40,6 +49,19 @@ typedef struct threadArgs {
 
 #define EMU_DISPGFX_BASE (0xFF0A)
 
+#define EMU_HDD_BASE (0xFF10)
+#define EMU_HDD_STATUS_REG (EMU_HDD_BASE + 0)
+#define EMU_HDD_CMD_REG (EMU_HDD_BASE + 2)
+#define EMU_HDD_DATA_REG (EMU_HDD_BASE + 4)
+
+#define EMU_FLOPPY_DRIVE_REG (0xFF16)
+
+#define EMU_TIMER_BASE (0xFF18)
+#define EMU_TIMER_CTRL_REG (EMU_TIMER_BASE + 0)
+
+#define EMU_IRQC_BASE (0xFF1A)
+#define EMU_IRQC_PENDING_REG (EMU_IRQC_BASE + 0)
+
 // ─── Mutex + condition variables ─────────────────────────────────────────────
 extern pthread_mutex_t kbdLock;
 extern pthread_cond_t kbdCond;
@@ -49,6 +71,8 @@ extern pthread_mutex_t disptextLock;
 extern pthread_cond_t disptextCond;
 extern pthread_mutex_t dispgfxLock;
 extern pthread_cond_t dispgfxCond;
+extern pthread_mutex_t hddLock;
+extern pthread_cond_t hddCond;
 
 // ─── Shared state ────────────────────────────────────────────────────────────
 extern uint8_t *mem6502;
@@ -56,9 +80,14 @@ extern volatile _Atomic int running;
 // Set to 1 after all devices are initialized; gates MMIO checks in
 // read6502/write6502 so binary loading doesn't false-match reg addresses.
 extern volatile int devicesReady;
-// Device threads set this to 1 to request an IRQ; the CPU main loop
-// delivers it between instructions (avoids data race on pc/sp/status).
+// The CPU IRQ line, set by irqcRaise (devices never touch it directly); the
+// CPU main loop delivers it between instructions (avoids data race on
+// pc/sp/status).
 extern volatile _Atomic int irqPending;
+// CPU cycle count, republished by the CPU thread after every instruction so
+// device threads can time themselves in emulated rather than host time.
+extern volatile _Atomic uint32_t cpuCycles;
+#define EMU_CPU_HZ 1000000 // nominal 6502 clock for cycle-timed devices
 
 // ─── 6502 defines ────────────────────────────────────────────────────────────
 #define UNDOCUMENTED // enable undocumented opcodes
@@ -140,6 +169,10 @@ extern uint8_t opcode, oldstatus;
 extern uint8_t read6502(uint16_t address);
 extern void write6502(uint16_t address, uint8_t value);
 
+// ─── Bulk DMA for device engines (wraps at $FFFF, skips device registers) ────
+extern void dma6502Write(uint16_t address, const uint8_t *src, uint32_t len);
+extern void dma6502Read(uint16_t address, uint8_t *dst, uint32_t len);
+
 // ─── Stack helpers
 // ────────────────────────────────────────────────────────────
 extern void push16(uint16_t pushval);
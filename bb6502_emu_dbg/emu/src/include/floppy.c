@@ -1,9 +1,11 @@
 #include "floppy.h"
+#include "blkdev.h"
 #include "fake6502.h"
 #include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -11,176 +13,368 @@
 #include <unistd.h>
 #endif
 
-static void floppyReadSector(void);
-static void floppyWriteSector(void);
-static void floppyDelayMs(int milliseconds);
-static void floppySimulateDelayAndUpdateCHS(uint8_t targetCylinder,
-                                            uint8_t targetSector);
+static int floppyRequestValid(floppy_t *d, uint8_t count);
+static void floppyReadSectors(floppy_t *d, uint8_t count);
+static void floppyWriteSectors(floppy_t *d, uint8_t count);
+static void floppyRunQueue(floppy_t *d);
+static void floppyReadSector(floppy_t *d, uint16_t lba,
+                             uint16_t dmaAddr);
+static void floppyWriteSector(floppy_t *d, uint16_t lba,
+                              uint16_t dmaAddr);
+static void floppyDelayUs(uint32_t microseconds);
+static double floppyHostMs(void);
+static void floppySimulateDelayAndUpdateCHS(floppy_t *d, uint8_t targetCylinder,
+                                            uint8_t targetHead,
+                                            uint8_t targetSector, int read);
 
 uint16_t floppyCmdRegAddr = 0;
 uint16_t floppyStatusRegAddr = 0;
 uint16_t floppyDataRegAddr = 0;
-char flpFileName[FILENAME_MAX] = {0};
+uint16_t floppyDriveRegAddr = 0;
+char flpFileName[FLOPPY_MAX_DRIVES][FILENAME_MAX] = {{0}};
+int flpDriveCount = 1;
+int flpReadOnly = 0;
+char flpOverlayFileName[FLOPPY_MAX_DRIVES][FILENAME_MAX] = {{0}};
 
-static FILE *flpFile;
-uint8_t *flpBuffer;
-floppy_t floppy;
-static pthread_t workerThread;
+floppy_timing_t flpTiming = FLOPPY_TIMING_REALISTIC;
+float flpTimingScale = 1.0f;
+int flpTrackCache = 1;
+
+// Simulated delay per component, and the host time actually spent on it
+typedef struct floppy_stats_t {
+  uint32_t accesses;
+  double seekMs, rotateMs, transferMs;
+  double waitedMs;
+} floppy_stats_t;
+
+static floppy_stats_t flpTimingStats[FLOPPY_MAX_DRIVES];
+static blkdev_t flpDev[FLOPPY_MAX_DRIVES];
+floppy_t floppy[FLOPPY_MAX_DRIVES];
+static uint8_t flpSelected;
+static pthread_t workerThread[FLOPPY_MAX_DRIVES];
+
+static uint16_t floppyReadPtr(uint16_t entry) {
+  return (uint16_t)read6502(entry) | ((uint16_t)read6502(entry + 1) << 8);
+}
+
+// Copy the selected drive's registers, and the IRQ mask, into guest memory.
+// Caller holds floppyLock.
+static void floppyMirror(void) {
+  mem6502[floppyStatusRegAddr] = floppy[flpSelected].status;
+  mem6502[floppyCmdRegAddr] = floppy[flpSelected].cmd;
+  if (floppyDriveRegAddr) {
+    uint8_t mask = 0;
+    for (int i = 0; i < FLOPPY_MAX_DRIVES; i++) {
+      if (floppy[i].status & FLOPPY_STATUS_IRQ)
+        mask |= (uint8_t)(1u << i);
+    }
+    mem6502[floppyDriveRegAddr] = flpSelected;
+    mem6502[(uint16_t)(floppyDriveRegAddr + 1)] = mask;
+  }
+}
+
+static uint8_t floppyGetStatus(floppy_t *d) {
+  pthread_mutex_lock(&floppyLock);
+  uint8_t st = d->status;
+  pthread_mutex_unlock(&floppyLock);
+  return st;
+}
+
+static void floppySetStatus(floppy_t *d, uint8_t st) {
+  pthread_mutex_lock(&floppyLock);
+  d->status = st;
+  floppyMirror();
+  pthread_mutex_unlock(&floppyLock);
+}
+
+static void floppyCmdDone(floppy_t *d) {
+  pthread_mutex_lock(&floppyLock);
+  d->cmd = FLOPPY_CMD_NO_CMD;
+  floppyMirror();
+  pthread_mutex_unlock(&floppyLock);
+}
 
 void floppyInit(void) {
-  // Read the 3 device-table entries (each is a 2-byte LE pointer)
-  floppyStatusRegAddr = (uint16_t)read6502(EMU_FLOPPY_STATUS_REG) |
-                        ((uint16_t)read6502(EMU_FLOPPY_STATUS_REG + 1) << 8);
-  floppyCmdRegAddr = (uint16_t)read6502(EMU_FLOPPY_CMD_REG) |
-                     ((uint16_t)read6502(EMU_FLOPPY_CMD_REG + 1) << 8);
-  floppyDataRegAddr = (uint16_t)read6502(EMU_FLOPPY_DATA_REG) |
-                      ((uint16_t)read6502(EMU_FLOPPY_DATA_REG + 1) << 8);
-
-  flpBuffer = (uint8_t *)malloc(FLOPPY_TOTAL_CAPACITY);
-  if (!flpBuffer) {
-    fprintf(stderr, "[FATAL] Couldn't allocate floppy buffer: %s\n",
-            strerror(errno));
-    exit(1);
+  // Read the device-table entries (each is a 2-byte LE pointer)
+  floppyStatusRegAddr = floppyReadPtr(EMU_FLOPPY_STATUS_REG);
+  floppyCmdRegAddr = floppyReadPtr(EMU_FLOPPY_CMD_REG);
+  floppyDataRegAddr = floppyReadPtr(EMU_FLOPPY_DATA_REG);
+  floppyDriveRegAddr = floppyReadPtr(EMU_FLOPPY_DRIVE_REG);
+  // A ROM without the entry reads erased flash ($FFFF): single drive
+  if (floppyDriveRegAddr == 0xFFFF || floppyDriveRegAddr == 0) {
+    floppyDriveRegAddr = 0;
+    if (flpDriveCount > 1) {
+      fprintf(stderr, "[WARN] ROM has no floppy DRIVE register, "
+                      "only drive A: is reachable\n");
+      flpDriveCount = 1;
+    }
   }
 
-  flpFile = fopen(flpFileName, "rb");
-  if (!flpFile) {
-    fprintf(stderr, "[WARN] No floppy image found, starting blank\n");
-    memset(flpBuffer, 0, FLOPPY_TOTAL_CAPACITY);
-  } else {
-    size_t r = fread(flpBuffer, 1, FLOPPY_TOTAL_CAPACITY, flpFile);
-    fclose(flpFile);
-    if (r != FLOPPY_TOTAL_CAPACITY) {
+  for (int i = 0; i < flpDriveCount; i++) {
+    floppy_t *d = &floppy[i];
+    const char *name = flpFileName[i];
+    const char *ovl = flpOverlayFileName[i];
+
+    // Map the image instead of reading it: sectors fault in on first access
+    if (ovl[0]) {
+      if (blkdevOpenOverlay(&flpDev[i], name, ovl, FLOPPY_TOTAL_CAPACITY,
+                            FLOPPY_BYTES_PER_SECTOR) < 0) {
+        fprintf(stderr, "[FATAL] Cannot open overlay %s over %s: %s\n", ovl,
+                name, strerror(errno));
+        exit(1);
+      }
+    } else if (blkdevOpen(&flpDev[i], name, FLOPPY_TOTAL_CAPACITY,
+                          FLOPPY_BYTES_PER_SECTOR, flpReadOnly) < 0) {
       fprintf(stderr,
-              "[FATAL] Invalid floppy image (expected %u bytes, got %zu)\n",
-              FLOPPY_TOTAL_CAPACITY, r);
-      free(flpBuffer);
+              "[FATAL] Invalid floppy image %s (expected %u bytes): %s\n",
+              name, FLOPPY_TOTAL_CAPACITY, strerror(errno));
       exit(1);
     }
+    if (!flpDev[i].fromFile) {
+      fprintf(stderr, "[WARN] No floppy image found for %c:, starting blank\n",
+              'A' + i);
+    }
+
+    d->id = (uint8_t)i;
+    d->count = 1;
+    d->seekUp = 1;
+    // The 6502 must see IDLE before it can issue any command.
+    d->status = FLOPPY_STATUS_IDLE;
+
+    // Joined by floppyCleanup() so the image is never unmapped mid-transfer
+    pthread_create(&workerThread[i], NULL, &floppyWorker, d);
   }
 
-  pthread_create(&workerThread, NULL, &floppyWorker, NULL);
-  pthread_detach(workerThread);
+  // calloc zeroed the registers; mirror drive A: explicitly so
+  // floppy_wait_idle doesn't spin forever on the very first call.
+  floppyMirror();
+}
 
-  // The 6502 must see IDLE before it can issue any command.
-  // calloc zeroed the register; set it explicitly so floppy_wait_idle
-  // doesn't spin forever on the very first call.
-  mem6502[floppyStatusRegAddr] = FLOPPY_STATUS_IDLE;
+// Runs on the CPU thread. Unattached drives answer every command at once with
+// ERROR, and with an IRQ for the commands that would have raised one.
+void floppyRegWrite(uint16_t address, uint8_t value) {
+  pthread_mutex_lock(&floppyLock);
+  if (address == floppyStatusRegAddr) {
+    floppy[flpSelected].status = value;
+  } else if (address == floppyCmdRegAddr) {
+    floppy_t *d = &floppy[flpSelected];
+    if (flpSelected >= flpDriveCount) {
+      if (value == FLOPPY_CMD_READ_SECTOR || value == FLOPPY_CMD_READ_MULTI ||
+          value == FLOPPY_CMD_WRITE_SECTOR || value == FLOPPY_CMD_WRITE_MULTI ||
+          value == FLOPPY_CMD_QUEUE_KICK) {
+        d->status = FLOPPY_STATUS_IDLE | FLOPPY_STATUS_ERROR | FLOPPY_STATUS_IRQ;
+        irqcRaise(IRQC_SRC_FLOPPY);
+      } else if (value != FLOPPY_CMD_NO_CMD) {
+        d->status = FLOPPY_STATUS_IDLE | FLOPPY_STATUS_ERROR;
+      }
+    } else {
+      d->cmd = value;
+      d->data = (uint16_t)mem6502[floppyDataRegAddr] |
+                ((uint16_t)mem6502[(uint16_t)(floppyDataRegAddr + 1)] << 8);
+      // Workers share the condvar; each one checks its own drive's cmd
+      if (value != FLOPPY_CMD_NO_CMD)
+        pthread_cond_broadcast(&floppyCond);
+    }
+  } else if (address == floppyDriveRegAddr) {
+    flpSelected = value % FLOPPY_MAX_DRIVES;
+    if (flpSelected >= flpDriveCount && floppy[flpSelected].status == 0)
+      floppy[flpSelected].status = FLOPPY_STATUS_IDLE | FLOPPY_STATUS_ERROR;
+  } else if (address == (uint16_t)(floppyDriveRegAddr + 1)) {
+    // Write-1-to-clear: acknowledge the completions of those drives
+    for (int i = 0; i < FLOPPY_MAX_DRIVES; i++) {
+      if (value & (1u << i))
+        floppy[i].status &= (uint8_t)~FLOPPY_STATUS_IRQ;
+    }
+  } else {
+    mem6502[address] = value;
+  }
+  floppyMirror();
+  pthread_mutex_unlock(&floppyLock);
 }
 
 void *floppyWorker(void *args) {
-  (void)args;
+  floppy_t *d = args;
 
   while (running) {
-    // Sleep until the CPU writes a non-zero command
+    // Sleep until the CPU writes a non-zero command for this drive
     pthread_mutex_lock(&floppyLock);
-    while ((mem6502[floppyCmdRegAddr] == FLOPPY_CMD_NO_CMD) && running) {
+    while ((d->cmd == FLOPPY_CMD_NO_CMD) && running) {
       pthread_cond_wait(&floppyCond, &floppyLock);
     }
+    uint8_t cmd = d->cmd;
     pthread_mutex_unlock(&floppyLock);
 
     if (!running)
       break;
 
     // Only service commands when idle or in error state
-    uint8_t st = read6502(floppyStatusRegAddr);
+    uint8_t st = floppyGetStatus(d);
     if (!(st & FLOPPY_STATUS_IDLE) && !(st & FLOPPY_STATUS_ERROR)) {
       continue;
     }
 
-    uint8_t cmd = read6502(floppyCmdRegAddr);
     switch (cmd) {
 
     case FLOPPY_CMD_RESET: {
-      st = read6502(floppyStatusRegAddr);
+      st = floppyGetStatus(d);
       st &= ~(FLOPPY_STATUS_IDLE);
       st |= FLOPPY_STATUS_BUSY;
-      write6502(floppyStatusRegAddr, st);
-      write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+      floppySetStatus(d, st);
+      d->count = 1;
+      floppyCmdDone(d);
       st &= ~FLOPPY_STATUS_BUSY;
       st |= (FLOPPY_STATUS_IDLE);
-      write6502(floppyStatusRegAddr, st);
+      floppySetStatus(d, st);
       break;
     }
 
     case FLOPPY_CMD_SET_DMA_ADDR: {
-      st = read6502(floppyStatusRegAddr);
+      st = floppyGetStatus(d);
       st &= ~(FLOPPY_STATUS_IDLE);
       st |= FLOPPY_STATUS_BUSY;
-      write6502(floppyStatusRegAddr, st);
-      floppy.dmaAddr = (uint16_t)read6502(floppyDataRegAddr) |
-                       ((uint16_t)read6502(floppyDataRegAddr + 1) << 8);
-      write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+      floppySetStatus(d, st);
+      d->dmaAddr = d->data;
+      floppyCmdDone(d);
       st &= ~FLOPPY_STATUS_BUSY;
       st |= (FLOPPY_STATUS_IDLE);
-      write6502(floppyStatusRegAddr, st);
+      floppySetStatus(d, st);
       break;
     }
 
     case FLOPPY_CMD_STORE_LBA: {
-      st = read6502(floppyStatusRegAddr);
+      st = floppyGetStatus(d);
       st &= ~(FLOPPY_STATUS_IDLE);
       st |= FLOPPY_STATUS_BUSY;
-      write6502(floppyStatusRegAddr, st);
-      floppy.lba = read6502(floppyDataRegAddr);
-      write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+      floppySetStatus(d, st);
+      d->lba = d->data;
+      floppyCmdDone(d);
       st &= ~FLOPPY_STATUS_BUSY;
       st |= (FLOPPY_STATUS_IDLE);
-      write6502(floppyStatusRegAddr, st);
+      floppySetStatus(d, st);
       break;
     }
 
-    case FLOPPY_CMD_READ_SECTOR: {
-      st = read6502(floppyStatusRegAddr);
+    case FLOPPY_CMD_SET_COUNT: {
+      st = floppyGetStatus(d);
+      st &= ~(FLOPPY_STATUS_IDLE);
+      st |= FLOPPY_STATUS_BUSY;
+      floppySetStatus(d, st);
+      d->count = (uint8_t)d->data;
+      floppyCmdDone(d);
+      st &= ~FLOPPY_STATUS_BUSY;
+      st |= (FLOPPY_STATUS_IDLE);
+      floppySetStatus(d, st);
+      break;
+    }
+
+    case FLOPPY_CMD_READ_SECTOR:
+    case FLOPPY_CMD_READ_MULTI: {
+      // Single-sector commands ignore the count register; MULTI moves
+      // d->count sectors with one DMA and one completion IRQ.
+      uint8_t n = (cmd == FLOPPY_CMD_READ_SECTOR) ? 1 : d->count;
+      st = floppyGetStatus(d);
       st &= ~(FLOPPY_STATUS_ERROR | FLOPPY_STATUS_IDLE | FLOPPY_STATUS_IRQ);
       st |= FLOPPY_STATUS_BUSY;
-      write6502(floppyStatusRegAddr, st);
-      if (floppy.lba >= FLOPPY_TOTAL_SECTORS) {
+      floppySetStatus(d, st);
+      if (!floppyRequestValid(d, n)) {
         st &= ~FLOPPY_STATUS_BUSY;
         st |= FLOPPY_STATUS_IDLE;
         st |= FLOPPY_STATUS_ERROR;
         st |= FLOPPY_STATUS_IRQ;
-        write6502(floppyStatusRegAddr, st);
-        write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+        floppySetStatus(d, st);
+        floppyCmdDone(d);
         // irq6502();
       } else {
-        floppyReadSector();
+        floppyReadSectors(d, n);
         st &= ~FLOPPY_STATUS_BUSY;
         st &= ~FLOPPY_STATUS_ERROR;
         st |= FLOPPY_STATUS_IDLE;
         st |= FLOPPY_STATUS_IRQ;
-        write6502(floppyStatusRegAddr, st);
-        write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+        floppySetStatus(d, st);
+        floppyCmdDone(d);
         // irq6502();
       }
-      irqPending = 1; // request IRQ safely (no data race)
+      irqcRaise(IRQC_SRC_FLOPPY); // request IRQ safely (no data race)
       break;
     }
 
-    case FLOPPY_CMD_WRITE_SECTOR: {
-      st = read6502(floppyStatusRegAddr);
+    case FLOPPY_CMD_WRITE_SECTOR:
+    case FLOPPY_CMD_WRITE_MULTI: {
+      // Single-sector commands ignore the count register; MULTI moves
+      // d->count sectors with one DMA and one completion IRQ.
+      uint8_t n = (cmd == FLOPPY_CMD_WRITE_SECTOR) ? 1 : d->count;
+      st = floppyGetStatus(d);
       st &= ~(FLOPPY_STATUS_ERROR | FLOPPY_STATUS_IDLE | FLOPPY_STATUS_IRQ);
       st |= FLOPPY_STATUS_BUSY;
-      write6502(floppyStatusRegAddr, st);
-      if (floppy.lba >= FLOPPY_TOTAL_SECTORS) {
+      floppySetStatus(d, st);
+      if (!floppyRequestValid(d, n)) {
         st &= ~FLOPPY_STATUS_BUSY;
         st |= FLOPPY_STATUS_IDLE;
         st |= FLOPPY_STATUS_ERROR;
         st |= FLOPPY_STATUS_IRQ;
-        write6502(floppyStatusRegAddr, st);
-        write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+        floppySetStatus(d, st);
+        floppyCmdDone(d);
         // irq6502();
       } else {
-        floppyWriteSector();
+        floppyWriteSectors(d, n);
         st &= ~FLOPPY_STATUS_BUSY;
         st &= ~FLOPPY_STATUS_ERROR;
         st |= FLOPPY_STATUS_IDLE;
         st |= FLOPPY_STATUS_IRQ;
-        write6502(floppyStatusRegAddr, st);
-        write6502(floppyCmdRegAddr, FLOPPY_CMD_NO_CMD);
+        floppySetStatus(d, st);
+        floppyCmdDone(d);
         // irq6502();
       }
-      irqPending = 1; // request IRQ safely (no data race)
+      irqcRaise(IRQC_SRC_FLOPPY); // request IRQ safely (no data race)
+      break;
+    }
+
+    case FLOPPY_CMD_SET_QUEUE: {
+      st = floppyGetStatus(d);
+      st &= ~(FLOPPY_STATUS_IDLE);
+      st |= FLOPPY_STATUS_BUSY;
+      floppySetStatus(d, st);
+      d->queueAddr = d->data;
+      floppyCmdDone(d);
+      st &= ~FLOPPY_STATUS_BUSY;
+      st |= (FLOPPY_STATUS_IDLE);
+      floppySetStatus(d, st);
+      break;
+    }
+
+    case FLOPPY_CMD_QUEUE_KICK: {
+      // Per-descriptor errors land in each descriptor's status byte; the
+      // ERROR bit here only means no queue was registered.
+      st = floppyGetStatus(d);
+      st &= ~(FLOPPY_STATUS_ERROR | FLOPPY_STATUS_IDLE | FLOPPY_STATUS_IRQ);
+      st |= FLOPPY_STATUS_BUSY;
+      floppySetStatus(d, st);
+      if (d->queueAddr) {
+        floppyRunQueue(d);
+      } else {
+        st |= FLOPPY_STATUS_ERROR;
+      }
+      st &= ~FLOPPY_STATUS_BUSY;
+      st |= FLOPPY_STATUS_IDLE;
+      st |= FLOPPY_STATUS_IRQ;
+      floppySetStatus(d, st);
+      floppyCmdDone(d);
+      irqcRaise(IRQC_SRC_FLOPPY);
+      break;
+    }
+
+    case FLOPPY_CMD_FLUSH: {
+      st = floppyGetStatus(d);
+      st &= ~(FLOPPY_STATUS_ERROR | FLOPPY_STATUS_IDLE);
+      st |= FLOPPY_STATUS_BUSY;
+      floppySetStatus(d, st);
+      if (blkdevFlush(&flpDev[d->id]) < 0) {
+        st |= FLOPPY_STATUS_ERROR;
+      }
+      floppyCmdDone(d);
+      st &= ~FLOPPY_STATUS_BUSY;
+      st |= (FLOPPY_STATUS_IDLE);
+      floppySetStatus(d, st);
       break;
     }
 
@@ -190,69 +384,284 @@ void *floppyWorker(void *args) {
     }
   }
 
-  free(flpBuffer);
   return NULL;
 }
 
-static void floppySimulateDelayAndUpdateCHS(uint8_t targetCylinder,
-                                            uint8_t targetSector) {
-  float rotation_time = 60000.0f / FLOPPY_RPM;
-  float sector_time = rotation_time / FLOPPY_SECTORS_PER_TRACK;
-
-  uint32_t cyl_diff = (uint32_t)abs((int)targetCylinder - (int)floppy.cylinder);
-  uint32_t seek_time = cyl_diff * FLOPPY_TRACK_TO_TRACK_SEEK_TIME;
-
-  float sector_diff =
-      (float)((targetSector - floppy.sector + FLOPPY_SECTORS_PER_TRACK) %
-              FLOPPY_SECTORS_PER_TRACK);
-  float rotation_latency = sector_diff * sector_time;
-  float transfer_time =
-      (sector_diff == 0.0f && cyl_diff > 0) ? 0.0f : sector_time;
-
-  float total_wait = (float)seek_time + rotation_latency + transfer_time;
-  floppy.cylinder = targetCylinder;
-  floppy.sector = (targetSector + 1) % FLOPPY_SECTORS_PER_TRACK;
-  floppyDelayMs((int)total_wait);
+// Called after running = 0 and floppyCond has been broadcast: waits for each
+// worker to finish its current command, then writes dirty sectors back.
+void floppyCleanup(void) {
+  static const char *names[] = {"instant", "realistic", "scaled"};
+  for (int i = 0; i < flpDriveCount; i++) {
+    floppy_t *d = &floppy[i];
+    floppy_stats_t *stats = &flpTimingStats[i];
+    pthread_join(workerThread[i], NULL);
+    blkdevClose(&flpDev[i]);
+
+    double simulated = stats->seekMs + stats->rotateMs + stats->transferMs;
+    fprintf(stderr,
+            "[FLOPPY] %c: timing=%s: %u sector accesses, simulated %.1f ms "
+            "(seek %.1f + rotation %.1f + transfer %.1f), host wait %.1f ms, "
+            "saved %.1f ms\n",
+            'A' + i, names[flpTiming], stats->accesses, simulated,
+            stats->seekMs, stats->rotateMs, stats->transferMs,
+            stats->waitedMs, simulated - stats->waitedMs);
+    if (flpTrackCache) {
+      fprintf(stderr, "[FLOPPY] %c: track buffer: %u hits, %u misses\n",
+              'A' + i, d->trackHits, d->trackMisses);
+    }
+  }
+}
+
+int floppySetTimingModel(const char *spec) {
+  if (strcmp(spec, "instant") == 0) {
+    flpTiming = FLOPPY_TIMING_INSTANT;
+  } else if (strcmp(spec, "realistic") == 0) {
+    flpTiming = FLOPPY_TIMING_REALISTIC;
+  } else if (strncmp(spec, "scaled:", 7) == 0) {
+    char *end;
+    float f = strtof(spec + 7, &end);
+    if (end == spec + 7 || *end != '\0' || !(f >= 0.0f)) {
+      return -1;
+    }
+    flpTiming = FLOPPY_TIMING_SCALED;
+    flpTimingScale = f;
+  } else {
+    return -1;
+  }
+  return 0;
 }
 
-static void floppyReadSector(void) {
-  uint8_t sector = (uint8_t)((floppy.lba % FLOPPY_SECTORS_PER_TRACK) + 1);
-  uint8_t cylinder =
-      (uint8_t)((floppy.lba / FLOPPY_SECTORS_PER_TRACK) / FLOPPY_HEADS);
-  floppySimulateDelayAndUpdateCHS(cylinder, sector);
+static void floppySimulateDelayAndUpdateCHS(floppy_t *d, uint8_t targetCylinder,
+                                            uint8_t targetHead,
+                                            uint8_t targetSector, int read) {
+  floppy_stats_t *stats = &flpTimingStats[d->id];
+  double rotation_time = 60000.0 / FLOPPY_RPM;
+  double sector_time = rotation_time / FLOPPY_SECTORS_PER_TRACK;
 
-  uint32_t offset = (uint32_t)floppy.lba * FLOPPY_BYTES_PER_SECTOR;
-  for (int i = 0; i < FLOPPY_BYTES_PER_SECTOR; i++) {
-    if ((uint32_t)(floppy.dmaAddr + i) > 0xFFFF)
-      break;
-    write6502((uint16_t)(floppy.dmaAddr + i), flpBuffer[offset + i]);
+  // The disk keeps spinning while the controller is idle: move the
+  // rotational position on by the emulated time since the last access.
+  double idle_ms = (double)(uint32_t)(cpuCycles - d->idleSince) /
+                   (EMU_CPU_HZ / 1000.0);
+  d->sector = (uint8_t)((d->sector + (uint32_t)(idle_ms / sector_time)) %
+                            FLOPPY_SECTORS_PER_TRACK);
+
+  uint32_t seek_time;
+  double rotation_latency, transfer_time;
+  if (read && flpTrackCache && d->trackValid &&
+      d->trackCylinder == targetCylinder && d->trackHead == targetHead) {
+    // Served from the track buffer: no seek and no rotational latency
+    d->trackHits++;
+    seek_time = 0;
+    rotation_latency = 0.0;
+    transfer_time = sector_time;
+    d->sector = (d->sector + 1) % FLOPPY_SECTORS_PER_TRACK;
+  } else {
+    uint32_t cyl_diff =
+        (uint32_t)abs((int)targetCylinder - (int)d->cylinder);
+    seek_time = cyl_diff * FLOPPY_TRACK_TO_TRACK_SEEK_TIME;
+
+    double sector_diff =
+        (double)((targetSector - d->sector + FLOPPY_SECTORS_PER_TRACK) %
+                 FLOPPY_SECTORS_PER_TRACK);
+    rotation_latency = sector_diff * sector_time;
+    transfer_time = (sector_diff == 0.0 && cyl_diff > 0) ? 0.0 : sector_time;
+
+    d->cylinder = targetCylinder;
+    d->head = targetHead;
+    d->sector = (targetSector + 1) % FLOPPY_SECTORS_PER_TRACK;
+
+    // A read leaves the whole track in the buffer; the rest of it streams
+    // in during the same revolution. Writes go straight to the media.
+    if (read && flpTrackCache) {
+      d->trackMisses++;
+      d->trackValid = 1;
+      d->trackCylinder = targetCylinder;
+      d->trackHead = targetHead;
+    }
+  }
+  double total_wait = (double)seek_time + rotation_latency + transfer_time;
+
+  stats->accesses++;
+  stats->seekMs += seek_time;
+  stats->rotateMs += rotation_latency;
+  stats->transferMs += transfer_time;
+
+  double t0 = floppyHostMs();
+  switch (flpTiming) {
+  case FLOPPY_TIMING_INSTANT:
+    break;
+
+  case FLOPPY_TIMING_REALISTIC: {
+    // Hold the command until the guest has run the equivalent number of
+    // cycles, however fast the host executes them.
+    uint32_t cycles = (uint32_t)(total_wait * (EMU_CPU_HZ / 1000.0));
+    uint32_t start = cpuCycles;
+    while (running && (uint32_t)(cpuCycles - start) < cycles) {
+      floppyDelayUs(50);
+    }
+    break;
+  }
+
+  case FLOPPY_TIMING_SCALED:
+    floppyDelayUs((uint32_t)(total_wait * flpTimingScale * 1000.0));
+    break;
   }
+  stats->waitedMs += floppyHostMs() - t0;
+  d->idleSince = cpuCycles;
 }
 
-static void floppyWriteSector(void) {
-  uint8_t sector = (uint8_t)((floppy.lba % FLOPPY_SECTORS_PER_TRACK) + 1);
-  uint8_t cylinder =
-      (uint8_t)((floppy.lba / FLOPPY_SECTORS_PER_TRACK) / FLOPPY_HEADS);
-  floppySimulateDelayAndUpdateCHS(cylinder, sector);
+// ─── Command queue ────────────────────────────────────────────────────────────
+typedef struct floppy_qdesc_t {
+  uint8_t  slot;
+  uint8_t  cmd;
+  uint8_t  count;
+  uint8_t  cylinder;
+  uint16_t lba;
+  uint16_t dmaAddr;
+} floppy_qdesc_t;
 
-  uint32_t offset = (uint32_t)floppy.lba * FLOPPY_BYTES_PER_SECTOR;
-  for (int i = 0; i < FLOPPY_BYTES_PER_SECTOR; i++) {
-    if ((uint32_t)(floppy.dmaAddr + i) > 0xFFFF)
-      break;
-    flpBuffer[offset + i] = read6502((uint16_t)(floppy.dmaAddr + i));
+static int floppyQdescCmp(const void *pa, const void *pb) {
+  const floppy_qdesc_t *a = pa, *b = pb;
+  if (a->cylinder != b->cylinder)
+    return (int)a->cylinder - (int)b->cylinder;
+  return (int)a->lba - (int)b->lba;
+}
+
+static void floppyRunQueueDesc(floppy_t *d, const floppy_qdesc_t *e) {
+  uint16_t statusAddr = (uint16_t)(d->queueAddr + 2 +
+                                   e->slot * FLOPPY_QUEUE_DESC_SIZE + 6);
+  uint8_t qst = FLOPPY_QSTAT_DONE;
+
+  d->lba = e->lba;
+  d->dmaAddr = e->dmaAddr;
+  if (!floppyRequestValid(d, e->count)) {
+    qst |= FLOPPY_QSTAT_ERROR;
+  } else if (e->cmd == FLOPPY_CMD_READ_MULTI) {
+    floppyReadSectors(d, e->count);
+  } else if (e->cmd == FLOPPY_CMD_WRITE_MULTI) {
+    floppyWriteSectors(d, e->count);
+  } else {
+    qst |= FLOPPY_QSTAT_ERROR;
+  }
+  dma6502Write(statusAddr, &qst, 1);
+}
+
+// Take every descriptor between tail and head and service them in LOOK order:
+// continue the current sweep from the head's cylinder to the furthest request
+// in that direction, then reverse for the rest. The direct-command registers
+// (lba, dmaAddr) are preserved. The ring is guest RAM and this runs on the
+// worker, so it is read and written by DMA like the sector data.
+static void floppyRunQueue(floppy_t *d) {
+  floppy_qdesc_t q[FLOPPY_QUEUE_SLOTS];
+  uint16_t ring = d->queueAddr;
+  uint8_t ht[2];
+  dma6502Read(ring, ht, 2);
+  uint8_t head = ht[0] % FLOPPY_QUEUE_SLOTS;
+  uint8_t tail = ht[1] % FLOPPY_QUEUE_SLOTS;
+  int n = 0;
+
+  for (uint8_t i = tail; i != head; i = (i + 1) % FLOPPY_QUEUE_SLOTS) {
+    uint8_t raw[6];
+    dma6502Read((uint16_t)(ring + 2 + i * FLOPPY_QUEUE_DESC_SIZE), raw, 6);
+    floppy_qdesc_t *e = &q[n++];
+    e->slot = i;
+    e->cmd = raw[0];
+    e->count = raw[1];
+    e->lba = (uint16_t)raw[2] | ((uint16_t)raw[3] << 8);
+    e->dmaAddr = (uint16_t)raw[4] | ((uint16_t)raw[5] << 8);
+    e->cylinder =
+        (uint8_t)((e->lba / FLOPPY_SECTORS_PER_TRACK) / FLOPPY_HEADS);
+  }
+  qsort(q, (size_t)n, sizeof(q[0]), floppyQdescCmp);
+
+  uint16_t savedLba = d->lba, savedDma = d->dmaAddr;
+  // First request at or beyond the head in the ascending order
+  int split = 0;
+  while (split < n && q[split].cylinder < d->cylinder)
+    split++;
+  if (d->seekUp) {
+    for (int i = split; i < n; i++)
+      floppyRunQueueDesc(d, &q[i]);
+    for (int i = split - 1; i >= 0; i--)
+      floppyRunQueueDesc(d, &q[i]);
+    if (split > 0)
+      d->seekUp = 0;
+  } else {
+    // Going down also takes requests on the head's own cylinder first
+    while (split < n && q[split].cylinder == d->cylinder)
+      split++;
+    for (int i = split - 1; i >= 0; i--)
+      floppyRunQueueDesc(d, &q[i]);
+    for (int i = split; i < n; i++)
+      floppyRunQueueDesc(d, &q[i]);
+    if (split < n)
+      d->seekUp = 1;
   }
+  d->lba = savedLba;
+  d->dmaAddr = savedDma;
+
+  dma6502Write((uint16_t)(ring + 1), &head, 1);
 }
 
-static void floppyDelayMs(int milliseconds) {
+// A transfer is valid if it moves at least one sector and stays on the disk.
+static int floppyRequestValid(floppy_t *d, uint8_t count) {
+  return count > 0 && (uint32_t)d->lba + count <= FLOPPY_TOTAL_SECTORS;
+}
+
+static void floppyReadSectors(floppy_t *d, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    floppyReadSector(d, (uint16_t)(d->lba + i),
+                     (uint16_t)(d->dmaAddr + i * FLOPPY_BYTES_PER_SECTOR));
+  }
+}
+
+static void floppyWriteSectors(floppy_t *d, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    floppyWriteSector(d, (uint16_t)(d->lba + i),
+                      (uint16_t)(d->dmaAddr + i * FLOPPY_BYTES_PER_SECTOR));
+  }
+}
+
+// Sector data moves with one bulk DMA; the DMA address wraps at $FFFF.
+static void floppyReadSector(floppy_t *d, uint16_t lba,
+                             uint16_t dmaAddr) {
+  uint8_t sector = (uint8_t)((lba % FLOPPY_SECTORS_PER_TRACK) + 1);
+  uint8_t cylinder = (uint8_t)((lba / FLOPPY_SECTORS_PER_TRACK) / FLOPPY_HEADS);
+  uint8_t head = (uint8_t)((lba / FLOPPY_SECTORS_PER_TRACK) % FLOPPY_HEADS);
+  floppySimulateDelayAndUpdateCHS(d, cylinder, head, sector, 1);
+
+  dma6502Write(dmaAddr, blkdevSector(&flpDev[d->id], lba),
+               FLOPPY_BYTES_PER_SECTOR);
+}
+
+static void floppyWriteSector(floppy_t *d, uint16_t lba,
+                              uint16_t dmaAddr) {
+  uint8_t sector = (uint8_t)((lba % FLOPPY_SECTORS_PER_TRACK) + 1);
+  uint8_t cylinder = (uint8_t)((lba / FLOPPY_SECTORS_PER_TRACK) / FLOPPY_HEADS);
+  uint8_t head = (uint8_t)((lba / FLOPPY_SECTORS_PER_TRACK) % FLOPPY_HEADS);
+  floppySimulateDelayAndUpdateCHS(d, cylinder, head, sector, 0);
+
+  dma6502Read(dmaAddr, blkdevSectorForWrite(&flpDev[d->id], lba),
+              FLOPPY_BYTES_PER_SECTOR);
+  blkdevMarkDirty(&flpDev[d->id], lba, 1);
+}
+
+static void floppyDelayUs(uint32_t microseconds) {
 #ifdef _WIN32
-  Sleep(milliseconds);
+  Sleep((microseconds + 999) / 1000);
 #else
   struct timespec ts;
-  ts.tv_sec = milliseconds / 1000;
-  ts.tv_nsec = (milliseconds % 1000) * 1000000L;
+  ts.tv_sec = microseconds / 1000000;
+  ts.tv_nsec = (long)(microseconds % 1000000) * 1000L;
   int res;
   do {
     res = nanosleep(&ts, &ts);
   } while (res && errno == EINTR);
 #endif
 }
+
+static double floppyHostMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
@@ -14,25 +14,72 @@
 #define FLOPPY_TRACKS_PER_SIDE      80
 #define FLOPPY_SIDES                2
 #define FLOPPY_TOTAL_CAPACITY       1474560  // bytes
+#define FLOPPY_MAX_DRIVES           4        // A: .. D:
 
 // ─── Actual register addresses (loaded from device table at init) ─────────────
 extern uint16_t floppyCmdRegAddr;
 extern uint16_t floppyStatusRegAddr;
 extern uint16_t floppyDataRegAddr;
+// DRIVE selects the drive STATUS/CMD/DATA talk to; DRIVE+1 holds one bit per
+// drive with a completion IRQ pending (write 1s to acknowledge). 0 when the
+// device table has no entry: only drive A: is reachable.
+extern uint16_t floppyDriveRegAddr;
 
-// Floppy image file name (set before floppyInit is called)
-extern char flpFileName[FILENAME_MAX];
+// One image per drive (set before floppyInit is called). Drives
+// 0 .. flpDriveCount-1 are attached; A: is always attached, blank if unnamed.
+extern char flpFileName[FLOPPY_MAX_DRIVES][FILENAME_MAX];
+extern int flpDriveCount;
+// Map the images MAP_PRIVATE: guest writes are never written back
+extern int flpReadOnly;
+// Copy-on-write overlay per drive; empty = write to the image itself
+extern char flpOverlayFileName[FLOPPY_MAX_DRIVES][FILENAME_MAX];
+
+// How the seek/rotation/transfer delay of each sector access is spent:
+//   instant    no delay at all
+//   realistic  the delay converted to emulated CPU cycles (EMU_CPU_HZ)
+//   scaled     the delay times flpTimingScale, slept in host time
+typedef enum {
+    FLOPPY_TIMING_INSTANT,
+    FLOPPY_TIMING_REALISTIC,
+    FLOPPY_TIMING_SCALED
+} floppy_timing_t;
+
+extern floppy_timing_t flpTiming;
+extern float flpTimingScale;
+// Track read-ahead buffer: 1 = enabled (default), 0 = every access is mechanical
+extern int flpTrackCache;
 
 // ─── Floppy commands ──────────────────────────────────────────────────────────
 enum floppy_commands_t {
     FLOPPY_CMD_NO_CMD       = 0x00,
     FLOPPY_CMD_RESET        = 0x01,
     FLOPPY_CMD_SET_DMA_ADDR = 0x02,
-    FLOPPY_CMD_STORE_LBA    = 0x03,
+    FLOPPY_CMD_STORE_LBA    = 0x03,  // DATA = 16-bit LE LBA
     FLOPPY_CMD_READ_SECTOR  = 0x04,
-    FLOPPY_CMD_WRITE_SECTOR = 0x05
+    FLOPPY_CMD_WRITE_SECTOR = 0x05,
+    FLOPPY_CMD_SET_COUNT    = 0x06,  // DATA low = sector count (1-255)
+    FLOPPY_CMD_READ_MULTI   = 0x07,  // read `count` sectors, one IRQ
+    FLOPPY_CMD_WRITE_MULTI  = 0x08,  // write `count` sectors, one IRQ
+    FLOPPY_CMD_FLUSH        = 0x09,  // msync dirty sectors to the image
+    FLOPPY_CMD_SET_QUEUE    = 0x0A,  // DATA = 16-bit address of the queue ring
+    FLOPPY_CMD_QUEUE_KICK   = 0x0B   // run every posted descriptor, one IRQ
 };
 
+// ─── Command queue ────────────────────────────────────────────────────────────
+// A ring of descriptors in guest RAM, registered with SET_QUEUE:
+//   +0        head: next slot the guest fills (written by the guest)
+//   +1        tail: next slot the controller takes (written by the controller)
+//   +2 + 8*n  descriptor n, n = 0 .. FLOPPY_QUEUE_SLOTS-1
+// Descriptor: cmd (READ_MULTI/WRITE_MULTI), count, LBA lo/hi, DMA lo/hi,
+// status, pad. The guest zeroes status when posting; the controller sets it
+// to QSTAT_DONE, or QSTAT_DONE|QSTAT_ERROR, as each descriptor completes.
+// QUEUE_KICK services tail..head in elevator (LOOK) order by cylinder.
+// head == tail means empty, so at most FLOPPY_QUEUE_SLOTS-1 are outstanding.
+#define FLOPPY_QUEUE_SLOTS      16
+#define FLOPPY_QUEUE_DESC_SIZE  8
+#define FLOPPY_QSTAT_DONE       0x80
+#define FLOPPY_QSTAT_ERROR      0x04
+
 // ─── Floppy status register bitmasks ─────────────────────────────────────────
 #define FLOPPY_STATUS_IDLE  0x01
 #define FLOPPY_STATUS_BUSY  0x02
@@ -40,20 +87,40 @@ enum floppy_commands_t {
 #define FLOPPY_STATUS_IRQ   0x08
 
 // ─── Floppy internal state ────────────────────────────────────────────────────
+// One per drive, each serviced by its own worker thread. The register block
+// is shared: the guest-visible STATUS and CMD mirror the selected drive, and
+// writing CMD latches the command and DATA into that drive, so a transfer on
+// one drive keeps running while the guest selects another and starts one.
 typedef struct floppy_t {
+    uint8_t  id;        // 0 = A:
     // 6502-invisible internal registers
     uint8_t  cylinder;
     uint8_t  head;
     uint8_t  sector;
     uint16_t lba;
     uint16_t dmaAddr;
-    // 6502-visible registers (mirrored in mem6502)
+    uint8_t  count;     // sectors moved by READ_MULTI / WRITE_MULTI
+    uint16_t queueAddr; // descriptor ring, 0 = none registered
+    uint8_t  seekUp;    // elevator sweep direction: 1 = toward cylinder 79
+    uint32_t idleSince; // cpuCycles when the last access finished
+    // Track read-ahead buffer: the last cylinder/head read in full
+    uint8_t  trackValid;
+    uint8_t  trackCylinder;
+    uint8_t  trackHead;
+    uint32_t trackHits;
+    uint32_t trackMisses;
+    // 6502-visible registers (mirrored in mem6502 while selected)
     uint8_t  status;
     uint8_t  cmd;
-    uint8_t  data;
+    uint16_t data;      // DATA latched when CMD was written
 } floppy_t;
 
-extern floppy_t floppy;
+extern floppy_t floppy[FLOPPY_MAX_DRIVES];
 
 extern void  floppyInit(void);
 extern void *floppyWorker(void *args);
+// MMIO write to STATUS, CMD, DRIVE or the IRQ mask (called by write6502)
+extern void  floppyRegWrite(uint16_t address, uint8_t value);
+extern void  floppyCleanup(void);
+// Parse "instant", "realistic" or "scaled:<factor>". Returns 0 or -1.
+extern int   floppySetTimingModel(const char *spec);
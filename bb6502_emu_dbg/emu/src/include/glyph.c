@@ -0,0 +1,103 @@
+// glyph.c — 8×8 glyph rasterizer (see glyph.h)
+//
+// A pixel is bg ^ ((fg ^ bg) & mask): the mask is all ones for a set font
+// bit. glyphMask holds the eight masks of every possible row byte (8 KB), so
+// the scalar and SSE2 paths never shift or test bits per pixel. AVX2 builds
+// the same mask in-register from a broadcast of the row byte.
+
+#include "glyph.h"
+
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define GLYPH_X86 1
+#include <immintrin.h>
+#endif
+
+static _Alignas(32) uint32_t glyphMask[256][GLYPH_W];
+static int glyphMaskReady = 0;
+
+static void glyphDrawScalar(uint32_t *dst, int pitch, const uint8_t *rows,
+                            uint32_t fg, uint32_t bg) {
+    uint32_t diff = fg ^ bg;
+    for (int y = 0; y < GLYPH_H; y++, dst += pitch) {
+        const uint32_t *m = glyphMask[rows[y]];
+        for (int x = 0; x < GLYPH_W; x++)
+            dst[x] = bg ^ (diff & m[x]);
+    }
+}
+
+#ifdef GLYPH_X86
+__attribute__((target("sse2")))
+static void glyphDrawSse2(uint32_t *dst, int pitch, const uint8_t *rows,
+                          uint32_t fg, uint32_t bg) {
+    __m128i f = _mm_set1_epi32((int)fg);
+    __m128i b = _mm_set1_epi32((int)bg);
+    for (int y = 0; y < GLYPH_H; y++, dst += pitch) {
+        const __m128i *m = (const __m128i *)glyphMask[rows[y]];
+        __m128i lo = _mm_load_si128(m);
+        __m128i hi = _mm_load_si128(m + 1);
+        _mm_storeu_si128((__m128i *)dst,
+                         _mm_or_si128(_mm_and_si128(lo, f),
+                                      _mm_andnot_si128(lo, b)));
+        _mm_storeu_si128((__m128i *)(dst + 4),
+                         _mm_or_si128(_mm_and_si128(hi, f),
+                                      _mm_andnot_si128(hi, b)));
+    }
+}
+
+__attribute__((target("avx2")))
+static void glyphDrawAvx2(uint32_t *dst, int pitch, const uint8_t *rows,
+                          uint32_t fg, uint32_t bg) {
+    const __m256i bits = _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10,
+                                           0x08, 0x04, 0x02, 0x01);
+    __m256i f = _mm256_set1_epi32((int)fg);
+    __m256i b = _mm256_set1_epi32((int)bg);
+    for (int y = 0; y < GLYPH_H; y++, dst += pitch) {
+        __m256i v = _mm256_and_si256(_mm256_set1_epi32(rows[y]), bits);
+        __m256i m = _mm256_cmpeq_epi32(v, bits);
+        _mm256_storeu_si256((__m256i *)dst, _mm256_blendv_epi8(b, f, m));
+    }
+}
+#endif
+
+glyph_draw_fn glyphDraw     = glyphDrawScalar;
+const char   *glyphImplName = "scalar";
+
+int glyphSelect(const char *name) {
+#ifdef GLYPH_X86
+    __builtin_cpu_init();
+    int hasSse2 = __builtin_cpu_supports("sse2");
+    int hasAvx2 = __builtin_cpu_supports("avx2");
+#else
+    int hasSse2 = 0, hasAvx2 = 0;
+#endif
+
+    if (strcmp(name, "auto") == 0)
+        name = hasAvx2 ? "avx2" : hasSse2 ? "sse2" : "scalar";
+
+    if (strcmp(name, "scalar") == 0) {
+        glyphDraw = glyphDrawScalar;
+#ifdef GLYPH_X86
+    } else if (strcmp(name, "sse2") == 0 && hasSse2) {
+        glyphDraw = glyphDrawSse2;
+    } else if (strcmp(name, "avx2") == 0 && hasAvx2) {
+        glyphDraw = glyphDrawAvx2;
+#endif
+    } else {
+        return -1;
+    }
+    glyphImplName = name;
+    return 0;
+}
+
+void glyphInit(void) {
+    if (!glyphMaskReady) {
+        for (int b = 0; b < 256; b++)
+            for (int x = 0; x < GLYPH_W; x++)
+                glyphMask[b][x] = ((b >> (7 - x)) & 1) ? 0xFFFFFFFFu : 0;
+        glyphMaskReady = 1;
+    }
+    glyphSelect("auto");
+}
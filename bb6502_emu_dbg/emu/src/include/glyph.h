@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// ─── 8×8 glyph rasterizer ────────────────────────────────────────────────────
+// Shared by dispgfx.c and tools/bbglyph.c (benchmark). Each font row byte
+// becomes eight ARGB8888 pixels, MSB leftmost: fg where the bit is set, bg
+// elsewhere. The implementation is chosen once at runtime:
+//
+//   avx2    mask from one compare against the bit weights, one blend per row
+//   sse2    two masks from the expansion table, and/andnot/or per half row
+//   scalar  expansion table, portable fallback (non-x86 hosts)
+
+#define GLYPH_W 8
+#define GLYPH_H 8
+
+// Draw one glyph. `rows` holds GLYPH_H font bytes, `pitch` is in pixels.
+typedef void (*glyph_draw_fn)(uint32_t *dst, int pitch, const uint8_t *rows,
+                              uint32_t fg, uint32_t bg);
+
+extern glyph_draw_fn glyphDraw;
+extern const char   *glyphImplName;
+
+// Build the expansion table and select the best implementation the CPU
+// supports. Safe to call more than once.
+extern void glyphInit(void);
+
+// Force "scalar", "sse2" or "avx2" ("auto" = best). Returns 0, or -1 if the
+// name is unknown or the CPU lacks the instruction set (selection unchanged).
+extern int  glyphSelect(const char *name);
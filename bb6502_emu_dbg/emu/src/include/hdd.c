@@ -0,0 +1,184 @@
+#include "hdd.h"
+#include "blkdev.h"
+#include "fake6502.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void hddSetStatus(uint8_t set, uint8_t clear);
+static void hddTransfer(uint8_t cmd, uint8_t count);
+
+uint16_t hddStatusRegAddr = 0;
+uint16_t hddCmdRegAddr = 0;
+uint16_t hddDataRegAddr = 0;
+char hddFileName[FILENAME_MAX] = {0};
+uint64_t hddCreateSize = HDD_DEFAULT_CAPACITY;
+
+static blkdev_t hddDev;
+hdd_t hdd;
+static pthread_t workerThread;
+static int workerStarted;
+
+static uint16_t hddTableEntry(uint16_t entry) {
+  return (uint16_t)read6502(entry) | ((uint16_t)read6502(entry + 1) << 8);
+}
+
+void hddInit(void) {
+  // Read the 3 device-table entries (each is a 2-byte LE pointer)
+  hddStatusRegAddr = hddTableEntry(EMU_HDD_STATUS_REG);
+  hddCmdRegAddr = hddTableEntry(EMU_HDD_CMD_REG);
+  hddDataRegAddr = hddTableEntry(EMU_HDD_DATA_REG);
+
+  // ROMs that predate the hard disk leave the table entries erased ($FFFF)
+  if (hddStatusRegAddr == 0xFFFF || hddCmdRegAddr == 0xFFFF ||
+      hddStatusRegAddr == hddCmdRegAddr) {
+    if (hddFileName[0]) {
+      fprintf(stderr, "[WARN] ROM has no hard disk device table entry\n");
+    }
+    hddStatusRegAddr = hddCmdRegAddr = hddDataRegAddr = 0;
+    return;
+  }
+
+  if (hddFileName[0]) {
+    if (blkdevCreate(hddFileName, hddCreateSize) == 0) {
+      fprintf(stderr, "[WARN] Created sparse %llu MiB hard disk image %s\n",
+              (unsigned long long)(hddCreateSize >> 20), hddFileName);
+    }
+    if (blkdevOpen(&hddDev, hddFileName, 0, HDD_BYTES_PER_SECTOR, 0) < 0 ||
+        hddDev.size > HDD_MAX_CAPACITY ||
+        hddDev.size % HDD_BYTES_PER_SECTOR != 0) {
+      fprintf(stderr,
+              "[FATAL] Invalid hard disk image %s (need a multiple of %u "
+              "bytes, at most 4 GiB): %s\n",
+              hddFileName, HDD_BYTES_PER_SECTOR, strerror(errno));
+      exit(1);
+    }
+    hdd.present = 1;
+  }
+
+  hdd.count = 1;
+  pthread_create(&workerThread, NULL, &hddWorker, NULL);
+  workerStarted = 1;
+
+  // Without a disk every transfer fails, but the guest can still probe it
+  mem6502[hddStatusRegAddr] = HDD_STATUS_IDLE;
+}
+
+void *hddWorker(void *args) {
+  (void)args;
+
+  while (running) {
+    // Sleep until the CPU writes a non-zero command
+    pthread_mutex_lock(&hddLock);
+    while ((mem6502[hddCmdRegAddr] == HDD_CMD_NO_CMD) && running) {
+      pthread_cond_wait(&hddCond, &hddLock);
+    }
+    pthread_mutex_unlock(&hddLock);
+
+    if (!running)
+      break;
+
+    uint8_t st = read6502(hddStatusRegAddr);
+    if (!(st & HDD_STATUS_IDLE) && !(st & HDD_STATUS_ERROR)) {
+      continue;
+    }
+
+    uint8_t cmd = read6502(hddCmdRegAddr);
+    hddSetStatus(HDD_STATUS_BUSY,
+                 HDD_STATUS_IDLE | HDD_STATUS_ERROR | HDD_STATUS_IRQ);
+    uint8_t err = 0, irq = 0;
+
+    switch (cmd) {
+    case HDD_CMD_RESET:
+      hdd.count = 1;
+      break;
+
+    case HDD_CMD_SET_DMA_ADDR:
+      hdd.dmaAddr = (uint16_t)read6502(hddDataRegAddr) |
+                    ((uint16_t)read6502(hddDataRegAddr + 1) << 8);
+      break;
+
+    case HDD_CMD_STORE_LBA:
+      hdd.lba = (uint32_t)read6502(hddDataRegAddr) |
+                ((uint32_t)read6502(hddDataRegAddr + 1) << 8) |
+                ((uint32_t)read6502(hddDataRegAddr + 2) << 16) |
+                ((uint32_t)read6502(hddDataRegAddr + 3) << 24);
+      break;
+
+    case HDD_CMD_SET_COUNT:
+      hdd.count = read6502(hddDataRegAddr);
+      break;
+
+    case HDD_CMD_IDENTIFY: {
+      uint32_t n = hdd.present ? hddDev.nSectors : 0;
+      for (int i = 0; i < 4; i++) {
+        write6502((uint16_t)(hddDataRegAddr + i), (uint8_t)(n >> (8 * i)));
+      }
+      break;
+    }
+
+    case HDD_CMD_FLUSH:
+      err = hdd.present && blkdevFlush(&hddDev) < 0;
+      break;
+
+    case HDD_CMD_READ_SECTOR:
+    case HDD_CMD_WRITE_SECTOR:
+    case HDD_CMD_READ_MULTI:
+    case HDD_CMD_WRITE_MULTI: {
+      uint8_t n = (cmd == HDD_CMD_READ_SECTOR || cmd == HDD_CMD_WRITE_SECTOR)
+                      ? 1
+                      : hdd.count;
+      if (!hdd.present || n == 0 || hdd.lba >= hddDev.nSectors ||
+          n > hddDev.nSectors - hdd.lba) {
+        err = 1;
+      } else {
+        hddTransfer(cmd, n);
+      }
+      // Transfers complete with an IRQ, configuration commands do not
+      irq = 1;
+      break;
+    }
+
+    default:
+      err = 1;
+      break;
+    }
+
+    // Final status before the IRQ: the handler reads ERROR right away
+    write6502(hddCmdRegAddr, HDD_CMD_NO_CMD);
+    hddSetStatus(HDD_STATUS_IDLE | (err ? HDD_STATUS_ERROR : 0) |
+                     (irq ? HDD_STATUS_IRQ : 0),
+                 HDD_STATUS_BUSY);
+    if (irq)
+      irqcRaise(IRQC_SRC_HDD);
+  }
+
+  return NULL;
+}
+
+// Called after running = 0 and hddCond has been signalled.
+void hddCleanup(void) {
+  if (workerStarted) {
+    pthread_join(workerThread, NULL);
+  }
+  blkdevClose(&hddDev);
+}
+
+static void hddSetStatus(uint8_t set, uint8_t clear) {
+  uint8_t st = read6502(hddStatusRegAddr);
+  st = (uint8_t)((st & ~clear) | set);
+  write6502(hddStatusRegAddr, st);
+}
+
+// Sectors are contiguous in the mapping, so a whole run is one bulk DMA.
+static void hddTransfer(uint8_t cmd, uint8_t count) {
+  uint32_t bytes = (uint32_t)count * HDD_BYTES_PER_SECTOR;
+  uint8_t *p = blkdevSector(&hddDev, hdd.lba);
+  if (cmd == HDD_CMD_READ_SECTOR || cmd == HDD_CMD_READ_MULTI) {
+    dma6502Write(hdd.dmaAddr, p, bytes);
+  } else {
+    dma6502Read(hdd.dmaAddr, p, bytes);
+    blkdevMarkDirty(&hddDev, hdd.lba, count);
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// ─── Hard disk parameters ─────────────────────────────────────────────────────
+// Same register protocol as the floppy, but with a 32-bit LBA and no
+// mechanical model: transfers complete as fast as the host can memcpy.
+#define HDD_BYTES_PER_SECTOR   512
+#define HDD_MAX_CAPACITY       0x100000000ULL  // 4 GiB, 2^23 sectors
+#define HDD_DEFAULT_CAPACITY   HDD_MAX_CAPACITY // size of a newly created image
+
+// ─── Actual register addresses (loaded from device table at init) ─────────────
+// DATA is 4 bytes wide (DATA+0 .. DATA+3) so it can hold a full LBA.
+extern uint16_t hddStatusRegAddr;
+extern uint16_t hddCmdRegAddr;
+extern uint16_t hddDataRegAddr;
+
+// Hard disk image (set before hddInit is called); empty = no disk attached.
+// A missing file is created sparse with hddCreateSize bytes.
+extern char hddFileName[FILENAME_MAX];
+extern uint64_t hddCreateSize;   // default HDD_DEFAULT_CAPACITY
+
+// ─── Hard disk commands ───────────────────────────────────────────────────────
+enum hdd_commands_t {
+    HDD_CMD_NO_CMD       = 0x00,
+    HDD_CMD_RESET        = 0x01,
+    HDD_CMD_SET_DMA_ADDR = 0x02,  // DATA = 16-bit LE address
+    HDD_CMD_STORE_LBA    = 0x03,  // DATA = 32-bit LE LBA
+    HDD_CMD_READ_SECTOR  = 0x04,
+    HDD_CMD_WRITE_SECTOR = 0x05,
+    HDD_CMD_SET_COUNT    = 0x06,  // DATA low = sector count (1-255)
+    HDD_CMD_READ_MULTI   = 0x07,  // read `count` sectors, one IRQ
+    HDD_CMD_WRITE_MULTI  = 0x08,  // write `count` sectors, one IRQ
+    HDD_CMD_FLUSH        = 0x09,  // msync dirty sectors to the image
+    HDD_CMD_IDENTIFY     = 0x0A   // DATA <- 32-bit LE sector count
+};
+
+// ─── Hard disk status register bitmasks (same layout as the floppy) ──────────
+#define HDD_STATUS_IDLE  0x01
+#define HDD_STATUS_BUSY  0x02
+#define HDD_STATUS_ERROR 0x04
+#define HDD_STATUS_IRQ   0x08
+
+// ─── Hard disk internal state ─────────────────────────────────────────────────
+typedef struct hdd_t {
+    uint32_t lba;
+    uint16_t dmaAddr;
+    uint8_t  count;     // sectors moved by READ_MULTI / WRITE_MULTI
+    uint8_t  present;   // 0 when no image is attached or no table entry
+} hdd_t;
+
+extern hdd_t hdd;
+
+extern void  hddInit(void);
+extern void *hddWorker(void *args);
+extern void  hddCleanup(void);
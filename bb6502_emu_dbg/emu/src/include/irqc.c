@@ -0,0 +1,98 @@
+#include "irqc.h"
+#include "fake6502.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+uint16_t irqcPendingRegAddr = 0;
+
+static _Atomic uint8_t pending;
+static _Atomic uint8_t mask;
+static _Atomic unsigned long long raised[IRQC_SOURCES];
+
+static const char *const sourceNames[IRQC_SOURCES] = {
+    "timer", "kbd", "hdd", "floppy", "dispgfx"};
+
+static uint16_t irqcTableEntry(uint16_t entry) {
+  return (uint16_t)read6502(entry) | ((uint16_t)read6502(entry + 1) << 8);
+}
+
+void irqcInit(void) {
+  irqcPendingRegAddr = irqcTableEntry(EMU_IRQC_PENDING_REG);
+  // ROMs that predate the controller leave the table entry erased ($FFFF)
+  if (irqcPendingRegAddr == 0xFFFF) {
+    irqcPendingRegAddr = 0;
+  }
+}
+
+// Flag the CPU to look at the line if an unmasked source is pending. Raise
+// and MASK/ACK each update their own register before looking at the other,
+// so a race between them can cost a spurious look but never a lost IRQ.
+static void irqcUpdateLine(void) {
+  if (atomic_load(&pending) & atomic_load(&mask))
+    irqPending = 1;
+}
+
+int irqcLineActive(void) {
+  if (!irqcPendingRegAddr)
+    return 0;
+  return (atomic_load(&pending) & atomic_load(&mask)) != 0;
+}
+
+void irqcRaise(int source) {
+  atomic_fetch_add_explicit(&raised[source], 1, memory_order_relaxed);
+  if (!irqcPendingRegAddr) {
+    irqPending = 1;
+    return;
+  }
+  atomic_fetch_or(&pending, (uint8_t)(1u << source));
+  irqcUpdateLine();
+}
+
+uint8_t irqcRegRead(uint16_t address) {
+  switch ((uint16_t)(address - irqcPendingRegAddr)) {
+  case 0:
+    return atomic_load(&pending);
+  case 1:
+    return atomic_load(&mask);
+  case 2: {
+    uint8_t active = atomic_load(&pending) & atomic_load(&mask);
+    for (int i = 0; i < IRQC_SOURCES; i++) {
+      if (active & (1u << i))
+        return (uint8_t)(2 * i);
+    }
+    return IRQC_CAUSE_NONE;
+  }
+  default:
+    return 0;
+  }
+}
+
+void irqcRegWrite(uint16_t address, uint8_t value) {
+  switch ((uint16_t)(address - irqcPendingRegAddr)) {
+  case 1:
+    atomic_store(&mask, value);
+    irqcUpdateLine();
+    break;
+  case 3:
+    atomic_fetch_and(&pending, (uint8_t)~value);
+    irqcUpdateLine();
+    break;
+  default:
+    break; // PENDING and CAUSE are read-only
+  }
+}
+
+void irqcCleanup(void) {
+  unsigned long long total = 0;
+  for (int i = 0; i < IRQC_SOURCES; i++)
+    total += raised[i];
+  if (total == 0)
+    return;
+  fprintf(stderr, "[IRQC] %llu IRQs:", total);
+  for (int i = 0; i < IRQC_SOURCES; i++) {
+    if (sourceNames[i])
+      fprintf(stderr, " %s %llu", sourceNames[i], atomic_load(&raised[i]));
+  }
+  fprintf(stderr, "\n");
+}
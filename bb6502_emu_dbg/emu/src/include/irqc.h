@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+// ─── Interrupt controller ────────────────────────────────────────────────────
+// Every device IRQ goes through irqcRaise(), which latches the source's
+// pending bit and asserts the CPU IRQ line if that source is unmasked.
+// Four consecutive registers starting at the device table entry:
+//   +0 PENDING  latched source bits, masked or not (read only)
+//   +1 MASK     1 = source may interrupt the CPU; 0 after power-on
+//   +2 CAUSE    2 × number of the pending unmasked source that comes first
+//               in priority order, or IRQC_CAUSE_NONE: a word-table index
+//   +3 ACK      write 1s to clear pending bits (reads 0)
+// The line is a level: it stays asserted while any unmasked bit is pending,
+// so a handler that returns with a source still pending (the next one, or
+// one it didn't ack) is entered again as soon as IRQs are enabled. The
+// devices keep their own status bits; ACK only clears the controller's.
+// ROMs without the table entry get the old behaviour: every raise simply
+// asserts the line.
+
+// ─── Actual register address (loaded from device table at init) ──────────────
+extern uint16_t irqcPendingRegAddr;   // 0 = ROM has no controller entry
+
+// ─── Sources, highest priority first ─────────────────────────────────────────
+enum irqc_source_t {
+    IRQC_SRC_TIMER   = 0,
+    IRQC_SRC_KBD     = 1,
+    IRQC_SRC_HDD     = 2,
+    IRQC_SRC_FLOPPY  = 3,
+    IRQC_SRC_DISPGFX = 4,
+    IRQC_SOURCES     = 8   // width of the registers
+};
+
+#define IRQC_CAUSE_NONE (2 * IRQC_SOURCES)
+
+extern void    irqcInit(void);
+extern void    irqcRaise(int source);   // any thread
+extern int     irqcLineActive(void);    // an unmasked source is pending
+extern uint8_t irqcRegRead(uint16_t address);
+extern void    irqcRegWrite(uint16_t address, uint8_t value);
+extern void    irqcCleanup(void);
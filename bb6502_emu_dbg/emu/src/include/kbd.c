@@ -25,7 +25,7 @@ static void disableRawMode(void) {
 
 static void kbdDataWrite(uint8_t k) {
   write6502(kbdDataRegAddr, k);
-  irqPending = 1; // request IRQ safely; CPU delivers it between instructions
+  irqcRaise(IRQC_SRC_KBD); // CPU delivers it between instructions
 }
 
 void kbdInit(void) {
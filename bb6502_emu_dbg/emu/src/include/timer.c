@@ -0,0 +1,103 @@
+#include "timer.h"
+#include "fake6502.h"
+#include <stdint.h>
+
+uint16_t timerCtrlRegAddr = 0;
+timerdev_t timerDev;
+
+static uint16_t timerTableEntry(uint16_t entry) {
+  return (uint16_t)read6502(entry) | ((uint16_t)read6502(entry + 1) << 8);
+}
+
+void timerInit(void) {
+  timerCtrlRegAddr = timerTableEntry(EMU_TIMER_CTRL_REG);
+  // ROMs that predate the timer leave the table entry erased ($FFFF)
+  if (timerCtrlRegAddr == 0xFFFF) {
+    timerCtrlRegAddr = 0;
+  }
+}
+
+// Load the counter from RELOAD and schedule the expiry after it
+static void timerStart(uint32_t from) {
+  timerDev.shift = (uint8_t)(((timerDev.ctrl & TIMER_CTRL_DIV_MASK) >>
+                              TIMER_CTRL_DIV_SHIFT) * 4);
+  uint32_t ticks = timerDev.reload ? timerDev.reload : 0x10000;
+  timerDev.period = ticks << timerDev.shift;
+  timerDev.deadline = from + timerDev.period;
+  timerDev.armed = 1;
+}
+
+// Ticks left, rounded up: the count only reaches 0 at the expiry itself
+static uint16_t timerCount(void) {
+  if (!timerDev.armed)
+    return timerDev.stopped;
+  int32_t left = (int32_t)(timerDev.deadline - clockticks6502);
+  if (left <= 0)
+    return 0;
+  uint32_t ticks = ((uint32_t)left + (1u << timerDev.shift) - 1) >>
+                   timerDev.shift;
+  return (uint16_t)ticks; // 65536 only at the very start: reads as 0
+}
+
+uint8_t timerRegRead(uint16_t address) {
+  switch ((uint16_t)(address - timerCtrlRegAddr)) {
+  case 0:
+    return timerDev.ctrl;
+  case 1: {
+    uint8_t v = timerDev.status | (timerDev.armed ? TIMER_STATUS_RUNNING : 0);
+    timerDev.status &= (uint8_t)~TIMER_STATUS_EXPIRED;
+    return v;
+  }
+  case 2: {
+    uint16_t count = timerCount();
+    timerDev.countHi = (uint8_t)(count >> 8);
+    return (uint8_t)count;
+  }
+  default:
+    return timerDev.countHi;
+  }
+}
+
+void timerRegWrite(uint16_t address, uint8_t value) {
+  switch ((uint16_t)(address - timerCtrlRegAddr)) {
+  case 0: {
+    uint8_t was = timerDev.ctrl;
+    timerDev.ctrl = value;
+    if ((value & TIMER_CTRL_RUN) && !(was & TIMER_CTRL_RUN)) {
+      timerStart(clockticks6502);
+    } else if (!(value & TIMER_CTRL_RUN) && timerDev.armed) {
+      timerDev.stopped = timerCount();
+      timerDev.armed = 0;
+    }
+    break;
+  }
+  case 1:
+    break; // read-only
+  case 2:
+    timerDev.reloadLo = value;
+    break;
+  default:
+    timerDev.reload = (uint16_t)(timerDev.reloadLo | (value << 8));
+    break;
+  }
+}
+
+void timerExpire(uint32_t now) {
+  timerDev.status |= TIMER_STATUS_EXPIRED;
+  if (timerDev.ctrl & TIMER_CTRL_IRQ)
+    irqcRaise(IRQC_SRC_TIMER);
+
+  if (!(timerDev.ctrl & TIMER_CTRL_PERIODIC)) {
+    timerDev.ctrl &= (uint8_t)~TIMER_CTRL_RUN;
+    timerDev.stopped = 0;
+    timerDev.armed = 0;
+    return;
+  }
+  // Count from the expiry, not from now, so the period never drifts. A
+  // period shorter than one instruction can't be kept: skip to the next one.
+  timerStart(timerDev.deadline);
+  if ((int32_t)(now - timerDev.deadline) >= 0) {
+    uint32_t behind = now - timerDev.deadline;
+    timerDev.deadline += (behind / timerDev.period + 1) * timerDev.period;
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+// ─── Interval timer ───────────────────────────────────────────────────────────
+// A 16-bit down counter clocked from emulated CPU cycles. It has no thread:
+// the registers are handled inline by read6502/write6502 and expiry is a
+// single compare in the CPU loop, so it is cycle exact and idle between
+// expirations. Four consecutive registers starting at the device table
+// entry:
+//   +0 CTRL    TIMER_CTRL_* bits
+//   +1 STATUS  TIMER_STATUS_* bits; reading clears EXPIRED
+//   +2 COUNT   lo: write = RELOAD lo, read = current count lo (latches hi)
+//   +3 COUNT   hi: write = RELOAD hi, read = the latched count hi
+// RUN going 0 -> 1 loads the counter from RELOAD (0 = 65536 ticks). A
+// periodic timer reloads on expiry from the RELOAD value current then,
+// without drift; a one-shot timer clears RUN. Prescaler changes take effect
+// on the next start.
+
+// ─── Actual register address (loaded from device table at init) ──────────────
+extern uint16_t timerCtrlRegAddr;   // 0 = ROM has no timer entry
+
+// ─── Timer control register bitmasks ─────────────────────────────────────────
+#define TIMER_CTRL_RUN       0x01
+#define TIMER_CTRL_PERIODIC  0x02
+#define TIMER_CTRL_IRQ       0x04   // raise an IRQ on every expiry
+#define TIMER_CTRL_DIV_MASK  0x30   // cycles per tick: 1, 16, 256, 4096
+#define TIMER_CTRL_DIV_SHIFT 4
+
+// ─── Timer status register bitmasks ──────────────────────────────────────────
+#define TIMER_STATUS_EXPIRED 0x01   // latched, cleared by reading STATUS
+#define TIMER_STATUS_RUNNING 0x80   // live copy of CTRL RUN
+
+// ─── Timer internal state ────────────────────────────────────────────────────
+typedef struct timerdev_t {
+    uint32_t deadline;      // clockticks6502 of the next expiry
+    uint32_t period;        // cycles per expiry, fixed at start / reload
+    uint16_t reload;
+    uint16_t stopped;       // count left when RUN was cleared
+    uint8_t  ctrl;
+    uint8_t  status;
+    uint8_t  reloadLo;      // RELOAD lo, committed by the hi write
+    uint8_t  countHi;       // latched by reading COUNT lo
+    uint8_t  armed;         // RUN is set: deadline is live
+    uint8_t  shift;         // log2(cycles per tick) of the running period
+} timerdev_t;
+
+extern timerdev_t timerDev;
+
+extern void    timerInit(void);
+extern uint8_t timerRegRead(uint16_t address);
+extern void    timerRegWrite(uint16_t address, uint8_t value);
+extern void    timerExpire(uint32_t now);
+
+// Called by the CPU thread after every instruction with clockticks6502
+static inline void timerTick(uint32_t now) {
+    if (timerDev.armed && (int32_t)(now - timerDev.deadline) >= 0)
+        timerExpire(now);
+}
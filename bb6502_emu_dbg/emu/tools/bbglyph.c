@@ -0,0 +1,134 @@
+// bbglyph — microbenchmark for the dispgfx glyph rasterizer (see glyph.h)
+//
+//   bbglyph [frames]
+//
+// Renders a full 40×30 screen (1200 cells, random glyphs and colours) into a
+// 320×240 ARGB buffer with every implementation the CPU supports, plus the
+// original bit-at-a-time loop as a reference:
+//   unthrottled  `frames` frames back to back (default 1000)
+//   60 Hz        60 frames, each started on a 16.7 ms tick
+// Every implementation's output is checked against the reference first.
+
+#include "glyph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COLS   40
+#define ROWS   30
+#define WIDTH  (COLS * GLYPH_W)
+#define HEIGHT (ROWS * GLYPH_H)
+#define CELLS  (COLS * ROWS)
+
+static uint32_t frame[WIDTH * HEIGHT];
+static uint32_t expect[WIDTH * HEIGHT];
+static uint8_t  font[128][GLYPH_H];
+static uint8_t  chars[CELLS];
+static uint32_t fgs[CELLS], bgs[CELLS];
+
+static void usage(void) {
+  fprintf(stdout, "Usage: bbglyph [frames]\n");
+  fprintf(stdout, "\tframes: unthrottled frames per implementation "
+                  "(default 1000)\n");
+}
+
+static double nowUs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+// The loop dispgfxRender used before glyph.c
+static void drawReference(uint32_t *dst, int pitch, const uint8_t *rows,
+                          uint32_t fg, uint32_t bg) {
+  for (int py = 0; py < GLYPH_H; py++) {
+    for (int px = 0; px < GLYPH_W; px++) {
+      int bit = (rows[py] >> (7 - px)) & 1;
+      dst[py * pitch + px] = bit ? fg : bg;
+    }
+  }
+}
+
+static void renderFrame(glyph_draw_fn draw, uint32_t *dst) {
+  for (int i = 0; i < CELLS; i++) {
+    int row = i / COLS, col = i % COLS;
+    draw(&dst[row * GLYPH_H * WIDTH + col * GLYPH_W], WIDTH, font[chars[i]],
+         fgs[i], bgs[i]);
+  }
+}
+
+static void sleepUntil(double targetUs) {
+  double left = targetUs - nowUs();
+  if (left <= 0)
+    return;
+  struct timespec ts;
+  ts.tv_sec = (time_t)(left / 1e6);
+  ts.tv_nsec = (long)(left - (double)ts.tv_sec * 1e6) * 1000L;
+  nanosleep(&ts, NULL);
+}
+
+static void bench(const char *name, glyph_draw_fn draw, int frames) {
+  memset(frame, 0, sizeof(frame));
+  renderFrame(draw, frame);
+  if (memcmp(frame, expect, sizeof(frame)) != 0) {
+    fprintf(stdout, "%-10s output differs from the reference\n", name);
+    return;
+  }
+
+  double t0 = nowUs();
+  for (int f = 0; f < frames; f++)
+    renderFrame(draw, frame);
+  double fast = (nowUs() - t0) / frames;
+
+  // 60 Hz: same work, paced like the render loop; report the busy time
+  const double tick = 1e6 / 60.0;
+  double busy = 0, start = nowUs();
+  for (int f = 0; f < 60; f++) {
+    sleepUntil(start + f * tick);
+    double s = nowUs();
+    renderFrame(draw, frame);
+    busy += nowUs() - s;
+  }
+  busy /= 60;
+
+  fprintf(stdout, "%-10s %9.1f %10.0f %11.1f %8.2f%%\n", name, fast,
+          1e6 / fast, busy, busy / tick * 100.0);
+}
+
+int main(int argc, char **argv) {
+  int frames = 1000;
+  if (argc > 2 || (argc == 2 && (frames = atoi(argv[1])) <= 0)) {
+    usage();
+    return 1;
+  }
+
+  // Fixed seed: identical screens across runs and implementations
+  srand(6502);
+  for (int c = 0; c < 128; c++)
+    for (int y = 0; y < GLYPH_H; y++)
+      font[c][y] = (uint8_t)rand();
+  for (int i = 0; i < CELLS; i++) {
+    chars[i] = (uint8_t)(rand() & 0x7F);
+    fgs[i] = 0xFF000000u | (uint32_t)rand();
+    bgs[i] = 0xFF000000u | (uint32_t)rand();
+  }
+
+  glyphInit();
+  fprintf(stdout, "%d cells/frame, auto-selected: %s\n", CELLS,
+          glyphImplName);
+  fprintf(stdout, "%-10s %9s %10s %11s %9s\n", "impl", "us/frame",
+          "frames/s", "60Hz us/fr", "of 60Hz");
+
+  renderFrame(drawReference, expect);
+  bench("reference", drawReference, frames);
+
+  static const char *impls[] = {"scalar", "sse2", "avx2"};
+  for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+    if (glyphSelect(impls[i]) == 0)
+      bench(impls[i], glyphDraw, frames);
+    else
+      fprintf(stdout, "%-10s not supported on this CPU\n", impls[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,74 @@
+// bbovl — inspect and commit copy-on-write floppy overlays (see blkdev.h)
+//
+//   bbovl list   <overlay>          changed sectors, as LBA ranges
+//   bbovl commit <overlay>          write them into the recorded base image
+
+#include "blkdev.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+static void usage(void) {
+  fprintf(stdout, "Usage: bbovl <command> <overlay>\n");
+  fprintf(stdout, "\tcommands:\n");
+  fprintf(stdout, "\t\tlist: print the sectors the overlay holds\n");
+  fprintf(stdout, "\t\tcommit: copy them into the base image and empty it\n");
+}
+
+static int ovlList(blkdev_t *dev) {
+  const blkdev_ovl_hdr_t *hdr = (const blkdev_ovl_hdr_t *)dev->ovl;
+  uint32_t changed = 0;
+
+  fprintf(stdout, "base: %s\n", hdr->basePath);
+  fprintf(stdout, "sectors: %u x %u bytes\n", dev->nSectors, dev->sectorSize);
+  for (uint32_t lba = 0; lba < dev->nSectors;) {
+    if (!blkdevOverlayHas(dev, lba)) {
+      lba++;
+      continue;
+    }
+    uint32_t end = lba;
+    while (end < dev->nSectors && blkdevOverlayHas(dev, end))
+      end++;
+    if (end - lba == 1)
+      fprintf(stdout, "  %u\n", lba);
+    else
+      fprintf(stdout, "  %u-%u\n", lba, end - 1);
+    changed += end - lba;
+    lba = end;
+  }
+  fprintf(stdout, "%u sector(s) changed\n", changed);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    usage();
+    return 1;
+  }
+
+  blkdev_t dev;
+  if (blkdevOpenOverlay(&dev, NULL, argv[2], 0, 0) < 0) {
+    fprintf(stderr, "[FATAL] Cannot open overlay %s: %s\n", argv[2],
+            strerror(errno));
+    return 1;
+  }
+
+  int rc = 0;
+  if (strcmp(argv[1], "list") == 0) {
+    rc = ovlList(&dev);
+  } else if (strcmp(argv[1], "commit") == 0) {
+    long n = blkdevOverlayCommit(&dev);
+    if (n < 0) {
+      fprintf(stderr, "[FATAL] Commit failed: %s\n", strerror(errno));
+      rc = 1;
+    } else {
+      fprintf(stdout, "%ld sector(s) committed\n", n);
+    }
+  } else {
+    usage();
+    rc = 1;
+  }
+
+  blkdevClose(&dev);
+  return rc;
+}
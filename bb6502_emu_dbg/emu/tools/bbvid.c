@@ -0,0 +1,393 @@
+// bbvid — expand a dispgfx video log (--record-video, see dispvid.h)
+//
+//   bbvid y4m <log> <out.y4m>       60 fps YUV4MPEG2, 640×480
+//   bbvid png <log> <prefix>        <prefix>-<frame>.png per changed frame
+//
+// The log only holds frames in which something changed; the y4m output
+// repeats the previous picture for the frames in between so playback keeps
+// the recorded timing. Every mode is scaled to 640×480 (nearest) there;
+// PNGs are written at the mode's own size.
+
+#include "dispgfx.h"
+#include "dispvid.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OUT_W 640
+#define OUT_H 480
+
+// ─── Display state rebuilt from the log ─────────────────────────────────────
+static uint32_t palette[DISPGFX_NUM_COLOURS];
+static uint8_t  font[128][DISPGFX_CHAR_H];
+static uint8_t  charRam[DISPGFX_GLYPHS][DISPGFX_CHAR_H];
+static int      useCharRam = 0;
+static int      mode = -1;
+static int      cols = DISPGFX_COLS, rows = DISPGFX_ROWS;
+static int      cursor = -1;
+static uint8_t  vram[DISPGFX_VRAM_MAX], cram[DISPGFX_VRAM_MAX];
+static uint8_t  bitmap[DISPGFX_BITMAP_SIZE];
+
+// Current picture, ARGB8888
+static uint32_t pixels[DISPGFX_MAX_WIDTH * DISPGFX_MAX_HEIGHT];
+static int      width = DISPGFX_WIDTH, height = DISPGFX_HEIGHT;
+
+static FILE *in;
+
+static void usage(void) {
+  fprintf(stdout, "Usage: bbvid <format> <log> <output>\n");
+  fprintf(stdout, "\tformats:\n");
+  fprintf(stdout, "\t\ty4m: one 640x480 60 fps video file\n");
+  fprintf(stdout, "\t\tpng: <output>-<frame>.png for every changed frame\n");
+}
+
+static void truncated(void) {
+  fprintf(stderr, "[FATAL] Log is truncated or corrupt\n");
+  exit(1);
+}
+
+static uint8_t get8(void) {
+  int c = fgetc(in);
+  if (c == EOF)
+    truncated();
+  return (uint8_t)c;
+}
+
+static uint16_t get16(void) {
+  uint16_t lo = get8();
+  return (uint16_t)(lo | (uint16_t)get8() << 8);
+}
+
+static void getBytes(uint8_t *dst, size_t n) {
+  if (fread(dst, 1, n, in) != n)
+    truncated();
+}
+
+// ─── Decoding ────────────────────────────────────────────────────────────────
+
+static void setMode(int m) {
+  mode = m;
+  cols = m == DISPGFX_MODE_TEXT80X25 || m == DISPGFX_MODE_TEXT80X50 ? 80 : 40;
+  rows = m == DISPGFX_MODE_TEXT80X25 ? 25
+         : m == DISPGFX_MODE_TEXT80X50 ? 50 : 30;
+  width = m == DISPGFX_MODE_BITMAP ? DISPGFX_WIDTH : cols * DISPGFX_CHAR_W;
+  height = m == DISPGFX_MODE_BITMAP ? DISPGFX_HEIGHT : rows * DISPGFX_CHAR_H;
+  useCharRam = 0;
+  memset(vram, 0, sizeof(vram));
+  memset(cram, 0, sizeof(cram));
+  memset(charRam, 0, sizeof(charRam));
+  memset(bitmap, 0, sizeof(bitmap));
+}
+
+static void scroll(int n) {
+  size_t keep = (size_t)((rows - (n > 0 ? n : -n)) * cols);
+  size_t gone = (size_t)(rows * cols) - keep;
+  if (n > 0) {
+    memmove(vram, vram + gone, keep);
+    memmove(cram, cram + gone, keep);
+    memset(vram + keep, 0, gone);
+    memset(cram + keep, 0, gone);
+  } else {
+    memmove(vram + gone, vram, keep);
+    memmove(cram + gone, cram, keep);
+    memset(vram, 0, gone);
+    memset(cram, 0, gone);
+  }
+}
+
+// Read one frame record; returns 0 at the end of the log
+static int readFrame(uint32_t *frame) {
+  int c = fgetc(in);
+  if (c == EOF)
+    return 0;
+  if (c != DISPVID_FRAME)
+    truncated();
+
+  uint32_t lo = get16();
+  *frame = lo | (uint32_t)get16() << 16;
+  int m = get8();
+  if (m != mode)
+    setMode(m);
+  uint16_t cur = get16();
+  cursor = cur == 0xFFFF ? -1 : cur;
+
+  for (;;) {
+    int op = get8();
+    if (op == DISPVID_END)
+      break;
+    switch (op) {
+    case DISPVID_SCROLL: {
+      int n = (int8_t)get8();
+      if (n > -rows && n < rows)
+        scroll(n);
+      break;
+    }
+    case DISPVID_FONT:
+      useCharRam = get8();
+      break;
+    case DISPVID_GLYPHS: {
+      int first = get8(), count = get8();
+      if (first + count > DISPGFX_GLYPHS)
+        truncated();
+      getBytes(charRam[first], (size_t)count * DISPGFX_CHAR_H);
+      break;
+    }
+    case DISPVID_CELLS: {
+      int first = get16(), count = get8();
+      if (first + count > DISPGFX_VRAM_MAX)
+        truncated();
+      for (int i = first; i < first + count; i++) {
+        vram[i] = get8();
+        cram[i] = get8();
+      }
+      break;
+    }
+    case DISPVID_BAND: {
+      int band = get8();
+      int len = DISPGFX_CHAR_H * DISPGFX_BITMAP_PITCH;
+      if (band >= DISPGFX_ROWS)
+        truncated();
+      getBytes(&bitmap[band * len], (size_t)len);
+      break;
+    }
+    default:
+      truncated();
+    }
+  }
+  return 1;
+}
+
+// ─── Rasterizing ─────────────────────────────────────────────────────────────
+
+static void render(void) {
+  if (mode == DISPGFX_MODE_BITMAP) {
+    for (int i = 0; i < DISPGFX_BITMAP_SIZE; i++) {
+      pixels[2 * i] = palette[bitmap[i] >> 4];
+      pixels[2 * i + 1] = palette[bitmap[i] & 0x0F];
+    }
+    return;
+  }
+  for (int i = 0; i < cols * rows; i++) {
+    uint8_t ch = vram[i], attr = cram[i];
+    const uint8_t *g = useCharRam ? charRam[ch] : font[ch < 128 ? ch : 0];
+    uint32_t fg = palette[attr & 0x0F], bg = palette[attr >> 4];
+    if (i == cursor) {
+      uint32_t t = fg;
+      fg = bg;
+      bg = t;
+    }
+    uint32_t *dst = &pixels[(i / cols) * DISPGFX_CHAR_H * width +
+                            (i % cols) * DISPGFX_CHAR_W];
+    for (int y = 0; y < DISPGFX_CHAR_H; y++, dst += width)
+      for (int x = 0; x < DISPGFX_CHAR_W; x++)
+        dst[x] = (g[y] >> (7 - x)) & 1 ? fg : bg;
+  }
+}
+
+// ─── YUV4MPEG2 ───────────────────────────────────────────────────────────────
+
+static uint8_t yPlane[OUT_W * OUT_H];
+static uint8_t uPlane[OUT_W * OUT_H / 4], vPlane[OUT_W * OUT_H / 4];
+
+// Full-range BT.601 (C420jpeg), chroma averaged over 2×2 pixels
+static void toYuv(void) {
+  for (int y = 0; y < OUT_H; y += 2) {
+    for (int x = 0; x < OUT_W; x += 2) {
+      int su = 0, sv = 0;
+      for (int k = 0; k < 4; k++) {
+        int px = x + (k & 1), py = y + (k >> 1);
+        uint32_t c = pixels[(py * height / OUT_H) * width + px * width / OUT_W];
+        int r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+        yPlane[py * OUT_W + px] =
+            (uint8_t)((19595 * r + 38470 * g + 7471 * b + 32768) >> 16);
+        su += -11059 * r - 21709 * g + 32768 * b;
+        sv += 32768 * r - 27439 * g - 5329 * b;
+      }
+      uPlane[(y / 2) * (OUT_W / 2) + x / 2] =
+          (uint8_t)(128 + (su / 4 + 32768) / 65536);
+      vPlane[(y / 2) * (OUT_W / 2) + x / 2] =
+          (uint8_t)(128 + (sv / 4 + 32768) / 65536);
+    }
+  }
+}
+
+static void writeY4mFrame(FILE *out) {
+  fputs("FRAME\n", out);
+  fwrite(yPlane, 1, sizeof(yPlane), out);
+  fwrite(uPlane, 1, sizeof(uPlane), out);
+  fwrite(vPlane, 1, sizeof(vPlane), out);
+}
+
+// ─── PNG (stored deflate blocks: no zlib needed) ─────────────────────────────
+
+static uint32_t crcTable[256];
+
+static uint32_t crc32(uint32_t crc, const uint8_t *p, size_t n) {
+  if (!crcTable[1]) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++)
+        c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      crcTable[i] = c;
+    }
+  }
+  crc = ~crc;
+  while (n--)
+    crc = crcTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void put32be(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static void writeChunk(FILE *out, const char *type, const uint8_t *data,
+                       size_t len) {
+  uint8_t hdr[8];
+  put32be(hdr, (uint32_t)len);
+  memcpy(hdr + 4, type, 4);
+  uint32_t crc = crc32(crc32(0, hdr + 4, 4), data, len);
+  uint8_t tail[4];
+  put32be(tail, crc);
+  fwrite(hdr, 1, 8, out);
+  fwrite(data, 1, len, out);
+  fwrite(tail, 1, 4, out);
+}
+
+static int writePng(const char *path) {
+  FILE *out = fopen(path, "wb");
+  if (!out) {
+    fprintf(stderr, "[FATAL] Cannot write %s: %s\n", path, strerror(errno));
+    return -1;
+  }
+
+  // Scanlines: filter byte 0, then RGB
+  size_t rawLen = (size_t)height * (size_t)(1 + 3 * width);
+  uint8_t *raw = malloc(rawLen);
+  size_t blocks = (rawLen + 65534) / 65535;
+  uint8_t *z = malloc(2 + rawLen + 5 * blocks + 4);
+  if (!raw || !z) {
+    fprintf(stderr, "[FATAL] Out of memory\n");
+    exit(1);
+  }
+  uint8_t *p = raw;
+  for (int y = 0; y < height; y++) {
+    *p++ = 0;
+    for (int x = 0; x < width; x++) {
+      uint32_t c = pixels[y * width + x];
+      *p++ = (uint8_t)(c >> 16);
+      *p++ = (uint8_t)(c >> 8);
+      *p++ = (uint8_t)c;
+    }
+  }
+
+  size_t zl = 0;
+  z[zl++] = 0x78;
+  z[zl++] = 0x01;
+  uint32_t a = 1, b = 0;
+  for (size_t off = 0; off < rawLen;) {
+    size_t n = rawLen - off < 65535 ? rawLen - off : 65535;
+    z[zl++] = off + n == rawLen;   // BFINAL, BTYPE 00 (stored)
+    z[zl++] = (uint8_t)n;
+    z[zl++] = (uint8_t)(n >> 8);
+    z[zl++] = (uint8_t)~n;
+    z[zl++] = (uint8_t)(~n >> 8);
+    memcpy(&z[zl], &raw[off], n);
+    for (size_t i = 0; i < n; i++) {
+      a = (a + raw[off + i]) % 65521;
+      b = (b + a) % 65521;
+    }
+    zl += n;
+    off += n;
+  }
+  put32be(&z[zl], b << 16 | a);
+  zl += 4;
+
+  static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  uint8_t ihdr[13] = {0};
+  put32be(ihdr, (uint32_t)width);
+  put32be(ihdr + 4, (uint32_t)height);
+  ihdr[8] = 8; // bit depth
+  ihdr[9] = 2; // truecolour
+  fwrite(sig, 1, sizeof(sig), out);
+  writeChunk(out, "IHDR", ihdr, sizeof(ihdr));
+  writeChunk(out, "IDAT", z, zl);
+  writeChunk(out, "IEND", NULL, 0);
+  free(raw);
+  free(z);
+  return fclose(out) == 0 ? 0 : -1;
+}
+
+// ─── Main ────────────────────────────────────────────────────────────────────
+
+int main(int argc, char **argv) {
+  if (argc != 4 || (strcmp(argv[1], "y4m") != 0 && strcmp(argv[1], "png") != 0)) {
+    usage();
+    return 1;
+  }
+  int png = strcmp(argv[1], "png") == 0;
+
+  in = fopen(argv[2], "rb");
+  if (!in) {
+    fprintf(stderr, "[FATAL] Cannot open %s: %s\n", argv[2], strerror(errno));
+    return 1;
+  }
+  char magic[8];
+  if (fread(magic, 1, 8, in) != 8 || memcmp(magic, DISPVID_MAGIC, 8) != 0) {
+    fprintf(stderr, "[FATAL] %s is not a dispgfx video log\n", argv[2]);
+    return 1;
+  }
+  for (int i = 0; i < DISPGFX_NUM_COLOURS; i++) {
+    uint32_t lo = get16();
+    palette[i] = lo | (uint32_t)get16() << 16;
+  }
+  getBytes(&font[0][0], sizeof(font));
+
+  FILE *out = NULL;
+  if (!png) {
+    out = fopen(argv[3], "wb");
+    if (!out) {
+      fprintf(stderr, "[FATAL] Cannot write %s: %s\n", argv[3],
+              strerror(errno));
+      return 1;
+    }
+    fprintf(out, "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n", OUT_W, OUT_H);
+  }
+
+  uint32_t frame = 0, records = 0, written = 0;
+  int havePrev = 0;
+  uint32_t prev = 0;
+  while (readFrame(&frame)) {
+    records++;
+    if (png) {
+      render();
+      char path[FILENAME_MAX];
+      snprintf(path, sizeof(path), "%s-%06u.png", argv[3], (unsigned)frame);
+      if (writePng(path) < 0)
+        return 1;
+      written++;
+      continue;
+    }
+    // Hold the previous picture until this record's frame
+    for (uint32_t f = prev + 1; havePrev && f < frame; f++, written++)
+      writeY4mFrame(out);
+    render();
+    toYuv();
+    writeY4mFrame(out);
+    written++;
+    prev = frame;
+    havePrev = 1;
+  }
+
+  if (out && fclose(out) != 0) {
+    fprintf(stderr, "[FATAL] Cannot write %s: %s\n", argv[3], strerror(errno));
+    return 1;
+  }
+  fprintf(stdout, "%u record(s), %u frame(s) written\n", records, written);
+  return 0;
+}
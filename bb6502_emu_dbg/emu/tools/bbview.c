@@ -0,0 +1,326 @@
+// bbview — watch emulators started with --shm, tiled on one terminal
+//
+//   bbview [-i ms] <name>...        live view, redrawn every `ms` (default 50)
+//   bbview -1 <name>...             print each screen once as plain text
+//
+// Each name is one emulator's --shm <name> (see dispshm.h). The objects are
+// mapped read-only, so any number of viewers can watch without the
+// emulators noticing. Only cells that changed since the last redraw are
+// sent to the terminal. Emulators that are not running yet, or exit, are
+// shown as waiting and picked up again when they (re)start. Text only:
+// guest-defined glyphs are shown as their ASCII codes, bitmap mode as a
+// note. Ctrl-C quits.
+
+#define _DEFAULT_SOURCE // nanosleep, shm_open under -std=c2x
+#include "dispshm.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_VIEWS 64
+
+// One copy of a frame, taken under the seqlock
+typedef struct {
+  uint32_t frame;
+  int      mode, hasVram, cols, rows;
+  int      cursor;               // cell index, -1 = hidden
+  uint8_t  vram[DISPGFX_VRAM_MAX];
+  uint8_t  cram[DISPGFX_VRAM_MAX];
+} snapshot_t;
+
+typedef struct {
+  const char      *name;
+  char             path[64];
+  const dispshm_t *shm;          // NULL = not attached
+  snapshot_t       snap;
+  int              ok;           // snap holds a frame
+  // What the terminal shows for this tile
+  int              drawn;        // 0 = repaint everything
+  int              text, cols;   // layout of the cells below
+  uint8_t          vram[DISPGFX_VRAM_MAX];
+  uint8_t          cram[DISPGFX_VRAM_MAX];
+  int              cursor;
+  char             title[128];
+} view_t;
+
+static view_t views[MAX_VIEWS];
+static int    nViews;
+static volatile sig_atomic_t quit = 0;
+
+// CGA palette index → ANSI colour number
+static const int ansiColour[8] = {0, 4, 2, 6, 1, 5, 3, 7};
+
+static void usage(void) {
+  fprintf(stdout, "Usage: bbview [-1] [-i ms] <name>...\n");
+  fprintf(stdout, "\tname: the emulator's --shm <name>\n");
+  fprintf(stdout, "\t-i ms: redraw interval (default 50)\n");
+  fprintf(stdout, "\t-1: print every screen once as text and exit\n");
+}
+
+static void onSignal(int sig) {
+  (void)sig;
+  quit = 1;
+}
+
+static void attach(view_t *v) {
+  int fd = shm_open(v->path, O_RDONLY, 0);
+  if (fd < 0)
+    return;
+  struct stat st;
+  void *p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(dispshm_t))
+    p = mmap(NULL, sizeof(dispshm_t), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return;
+  const dispshm_t *s = p;
+  if (memcmp(s->magic, DISPSHM_MAGIC, sizeof(s->magic)) != 0 ||
+      s->version != DISPSHM_VERSION || atomic_load(&s->closed)) {
+    munmap(p, sizeof(dispshm_t));
+    return;
+  }
+  v->shm = s;
+  v->drawn = 0;
+}
+
+static void detach(view_t *v) {
+  munmap((void *)v->shm, sizeof(dispshm_t));
+  v->shm = NULL;
+  v->ok = 0;
+  v->drawn = 0;
+}
+
+// Copy the current frame; gives up (keeping the old one) if the emulator
+// keeps rewriting it
+static void readSnapshot(view_t *v) {
+  const dispshm_t *s = v->shm;
+  snapshot_t *n = &v->snap;
+  for (int tries = 0; tries < 100; tries++) {
+    uint32_t seq = dispshmReadBegin(s);
+    if (seq & 1)
+      continue;
+    n->frame = s->frame;
+    n->mode = s->mode;
+    n->hasVram = s->hasVram;
+    n->cols = s->cols;
+    n->rows = s->rows;
+    n->cursor = -1;
+    if (n->cols > DISPGFX_MAX_COLS || n->rows > DISPGFX_MAX_ROWS)
+      n->hasVram = 0;
+    if (n->hasVram) {
+      memcpy(n->vram, s->vram, (size_t)(n->cols * n->rows));
+      memcpy(n->cram, s->cram, (size_t)(n->cols * n->rows));
+      if (s->cursorOn && s->cursorCol < n->cols && s->cursorRow < n->rows)
+        n->cursor = s->cursorRow * n->cols + s->cursorCol;
+    }
+    if (dispshmReadValid(s, seq)) {
+      v->ok = 1;
+      return;
+    }
+  }
+}
+
+static void pollView(view_t *v) {
+  if (v->shm && atomic_load(&v->shm->closed))
+    detach(v);
+  if (!v->shm)
+    attach(v);
+  if (v->shm)
+    readSnapshot(v);
+}
+
+static char cellChar(uint8_t c) { return c > ' ' && c < 127 ? (char)c : ' '; }
+
+// ─── -1: plain text ──────────────────────────────────────────────────────────
+
+static int printOnce(void) {
+  int missing = 0;
+  for (int i = 0; i < nViews; i++) {
+    view_t *v = &views[i];
+    pollView(v);
+    if (!v->ok) {
+      fprintf(stdout, "%s: not running\n", v->name);
+      missing = 1;
+      continue;
+    }
+    const snapshot_t *n = &v->snap;
+    fprintf(stdout, "%s: frame %u, %dx%d\n", v->name, n->frame, n->cols,
+            n->rows);
+    if (n->mode == DISPGFX_MODE_BITMAP) {
+      fprintf(stdout, "(bitmap mode)\n");
+      continue;
+    }
+    for (int r = 0; n->hasVram && r < n->rows; r++) {
+      char line[DISPGFX_MAX_COLS + 1];
+      int len = 0;
+      for (int c = 0; c < n->cols; c++) {
+        line[c] = cellChar(n->vram[r * n->cols + c]);
+        if (line[c] != ' ')
+          len = c + 1;
+      }
+      fprintf(stdout, "%.*s\n", len, line);
+    }
+  }
+  return missing;
+}
+
+// ─── Live view ───────────────────────────────────────────────────────────────
+
+static int lastAttr = -1;
+
+static void setAttr(uint8_t attr, int inverse) {
+  int a = inverse ? 0x100 | attr : attr;
+  if (a == lastAttr)
+    return;
+  lastAttr = a;
+  int fg = attr & 0x0F, bg = attr >> 4;
+  if (inverse) {
+    int t = fg;
+    fg = bg;
+    bg = t;
+  }
+  fprintf(stdout, "\033[0;%d;%dm", (fg & 8 ? 90 : 30) + ansiColour[fg & 7],
+          (bg & 8 ? 100 : 40) + ansiColour[bg & 7]);
+}
+
+static void drawTitle(view_t *v, int top, int left, int width) {
+  char title[128];
+  if (!v->ok)
+    snprintf(title, sizeof(title), "%s: waiting", v->name);
+  else if (v->snap.mode == DISPGFX_MODE_BITMAP)
+    snprintf(title, sizeof(title), "%s: frame %u (bitmap mode)", v->name,
+             v->snap.frame);
+  else
+    snprintf(title, sizeof(title), "%s: frame %u", v->name, v->snap.frame);
+  if (v->drawn && strcmp(title, v->title) == 0)
+    return;
+  strcpy(v->title, title);
+  lastAttr = -1;
+  fprintf(stdout, "\033[0;7m\033[%d;%dH%-*.*s", top, left, width, width,
+          title);
+}
+
+static void drawView(view_t *v, int top, int left, int width,
+                     int height) {
+  drawTitle(v, top, left, width);
+  const snapshot_t *n = &v->snap;
+  int text = v->ok && n->mode != DISPGFX_MODE_BITMAP && n->hasVram;
+
+  // Cells moved (mode switch, VRAM set or gone): start the tile over
+  if (text != v->text || (text && n->cols != v->cols))
+    v->drawn = 0;
+  v->text = text;
+  v->cols = n->cols;
+  if (!v->drawn) {
+    // Blank the tile, then every cell below counts as changed
+    lastAttr = -1;
+    fprintf(stdout, "\033[0m");
+    for (int r = 1; r <= height; r++)
+      fprintf(stdout, "\033[%d;%dH%*s", top + r, left, width, "");
+    memset(v->vram, 0, sizeof(v->vram));
+    memset(v->cram, 0, sizeof(v->cram));
+    v->cursor = -1;
+  }
+  v->drawn = 1;
+  if (!text)
+    return;
+
+  int curRow = -1, curCol = -1;
+  for (int i = 0; i < n->cols * n->rows; i++) {
+    int cursorCell = i == n->cursor || i == v->cursor;
+    if (n->vram[i] == v->vram[i] && n->cram[i] == v->cram[i] && !cursorCell)
+      continue;
+    int r = i / n->cols, c = i % n->cols;
+    if (r != curRow || c != curCol)
+      fprintf(stdout, "\033[%d;%dH", top + 1 + r, left + c);
+    setAttr(n->cram[i], i == n->cursor);
+    fputc(cellChar(n->vram[i]), stdout);
+    curRow = r;
+    curCol = c + 1;
+    v->vram[i] = n->vram[i];
+    v->cram[i] = n->cram[i];
+  }
+  v->cursor = n->cursor;
+}
+
+static int liveView(int intervalMs) {
+  static char outBuf[1 << 16];
+  setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  fprintf(stdout, "\033[?1049h\033[?25l\033[2J");
+
+  int tileW = 0, tileH = 0, perRow = 0;
+  while (!quit) {
+    int maxCols = DISPGFX_COLS, maxRows = DISPGFX_ROWS;
+    for (int i = 0; i < nViews; i++) {
+      pollView(&views[i]);
+      if (views[i].ok && views[i].snap.mode != DISPGFX_MODE_BITMAP) {
+        if (views[i].snap.cols > maxCols) maxCols = views[i].snap.cols;
+        if (views[i].snap.rows > maxRows) maxRows = views[i].snap.rows;
+      }
+    }
+
+    // Tiles as wide and tall as the largest screen, as many per line as fit
+    struct winsize ws;
+    int termCols = 80;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col)
+      termCols = ws.ws_col;
+    int w = maxCols + 2, h = maxRows + 2;
+    int per = termCols / w > 0 ? termCols / w : 1;
+    if (w != tileW || h != tileH || per != perRow) {
+      tileW = w;
+      tileH = h;
+      perRow = per;
+      fprintf(stdout, "\033[0m\033[2J");
+      for (int i = 0; i < nViews; i++)
+        views[i].drawn = 0;
+    }
+
+    for (int i = 0; i < nViews; i++)
+      drawView(&views[i], 1 + (i / perRow) * tileH, 1 + (i % perRow) * tileW,
+               maxCols, maxRows);
+    fflush(stdout);
+
+    struct timespec ts = {intervalMs / 1000, (intervalMs % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+  }
+
+  fprintf(stdout, "\033[0m\033[?25h\033[?1049l");
+  fflush(stdout);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int once = 0, intervalMs = 50;
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "-1") == 0) {
+      once = 1;
+    } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc &&
+               atoi(argv[i + 1]) > 0) {
+      intervalMs = atoi(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (i == argc || argc - i > MAX_VIEWS) {
+    usage();
+    return 1;
+  }
+  for (; i < argc; i++) {
+    view_t *v = &views[nViews++];
+    v->name = argv[i];
+    snprintf(v->path, sizeof(v->path), DISPSHM_PREFIX "%s", argv[i]);
+  }
+
+  return once ? printOnce() : liveView(intervalMs);
+}
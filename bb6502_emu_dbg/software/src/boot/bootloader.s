@@ -38,10 +38,11 @@ _bootloader:
     sta STRPTR+1
 
     ; ── floppy_read calling convention ────────────────────────
-    ; A = number of sectors to load
-    ; Y = starting LBA (0 = first sector of the floppy image)
+    ; A = number of sectors to load (moved in one multi-sector DMA)
+    ; X/Y = starting LBA hi/lo (0 = first sector of the floppy image)
     ; STRPTR = DMA destination address (set above)
     lda #BOOT_SECTOR_COUNT
+    ldx #0
     ldy #0
     jsr floppy_read
 
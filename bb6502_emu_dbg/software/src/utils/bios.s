@@ -13,8 +13,13 @@ BIOS_INCLUDED = 1
 .export reset
 .export puts, gets, putc, getc
 .export putsg, getsg, putcg, getcg
+.export dispgfx_wait_frame, dispgfx_set_mode
 .export hang, exit
-.export floppy_read, floppy_write
+.export floppy_read, floppy_write, floppy_flush
+.export floppy_select, floppy_start_read, floppy_start_write, floppy_wait
+.export floppy_queue_init, floppy_queue_kick
+.export hdd_read, hdd_write, hdd_flush, hdd_identify
+.export timer_delay
 .export nmi, irq
 
 ; ----------------------------------------
@@ -35,53 +40,21 @@ reset:
     lda #$00
     sta KBD_LAST
     sta FLOPPY_DONE
-
-    ; Initialise cursor position to (0,0)
-    sta DISPGFX_CURS_ROW
-    sta DISPGFX_CURS_COL
-
-    ; Initialise VRAM write pointer → start of VRAM
-    lda #<DISPGFX_VRAM_BASE
-    sta DISPGFX_VRAM_WPTR
-    lda #>DISPGFX_VRAM_BASE
-    sta DISPGFX_VRAM_WPTR+1
-
-    ; Initialise CRAM write pointer → start of CRAM
-    lda #<DISPGFX_CRAM_BASE
-    sta DISPGFX_CRAM_WPTR
-    lda #>DISPGFX_CRAM_BASE
-    sta DISPGFX_CRAM_WPTR+1
-
-    ; ── Tell emulator where VRAM lives ────────────────────────
-    lda #<DISPGFX_VRAM_BASE
-    sta DISPGFX_DATA_REG
-    lda #>DISPGFX_VRAM_BASE
-    sta DISPGFX_DATA_REG+1
-    lda #DISPGFX_CMD_SET_VRAM       ; NOTE: #immediate
-    sta DISPGFX_CMD_REG
-    jsr dispgfx_wait_idle
-
-    ; ── Tell emulator where CRAM lives ────────────────────────
-    lda #<DISPGFX_CRAM_BASE
-    sta DISPGFX_DATA_REG
-    lda #>DISPGFX_CRAM_BASE
-    sta DISPGFX_DATA_REG+1
-    lda #DISPGFX_CMD_SET_CRAM
-    sta DISPGFX_CMD_REG
-    jsr dispgfx_wait_idle
-
-    ; ── Clear screen ──────────────────────────────────────────
-    lda #DISPGFX_CMD_CLEAR
-    sta DISPGFX_CMD_REG
-    jsr dispgfx_wait_idle
-
-    ; ── Set hardware cursor at (0,0) ──────────────────────────
-    lda #$00
-    sta DISPGFX_DATA_REG            ; col = 0
-    sta DISPGFX_DATA_REG+1          ; row = 0
-    lda #DISPGFX_CMD_SET_CURSOR
-    sta DISPGFX_CMD_REG
-    jsr dispgfx_wait_idle
+    sta HDD_DONE
+    sta FLOPPY_DRIVE_REG    ; drive A:
+    sta DISPGFX_FRAMES
+    sta TIMER_CTRL_REG      ; timer stopped
+    sta TIMER_TICKS
+
+    ; ── Interrupt controller: drop stale IRQs, enable all ─────
+    lda #$FF
+    sta IRQC_ACK_REG
+    lda #IRQC_ALL
+    sta IRQC_MASK_REG
+
+    ; ── 40×30 text: VRAM/CRAM, clear screen, cursor at (0,0) ──
+    lda #DISPGFX_MODE_TEXT
+    jsr dispgfx_set_mode
 
     ; ── Enable blinking cursor ────────────────────────────────
     lda #DISPGFX_CMD_CURSOR_ON
@@ -131,16 +104,48 @@ exit:
 ;   Waits until CMD register reads NOP ($00) AND STATUS has IDLE.
 ;   Same pattern as _floppy_wait_cmd — prevents the race where
 ;   the BIOS sees stale IDLE before the worker has woken up.
+;   Reading STATUS clears the VBLANK latch, so a latched frame
+;   is counted in DISPGFX_FRAMES here rather than lost.
 ; ============================================================
 dispgfx_wait_idle:
     lda DISPGFX_CMD_REG
     bne dispgfx_wait_idle       ; spin until CMD = NOP ($00)
     lda DISPGFX_STATUS_REG
+    and #(DISPGFX_STATUS_IDLE | DISPGFX_STATUS_VBLANK)
+    cmp #DISPGFX_STATUS_VBLANK
+    bcc @idle                   ; VBLANK clear
+    inc DISPGFX_FRAMES
+@idle:
     and #DISPGFX_STATUS_IDLE
     beq dispgfx_wait_idle       ; also ensure IDLE is set
     rts
 
 
+; ============================================================
+; dispgfx_wait_frame — wait for the next displayed frame
+;   Returns once DISPGFX_FRAMES has changed. Works with the
+;   VBLANK IRQ enabled (the IRQ handler counts frames) or not
+;   (the STATUS latch is polled here).
+;
+; Clobbers: A.
+; ============================================================
+dispgfx_wait_frame:
+    lda DISPGFX_FRAMES
+    pha
+@poll:
+    lda DISPGFX_STATUS_REG      ; reading clears the latch
+    and #DISPGFX_STATUS_VBLANK
+    beq @check
+    inc DISPGFX_FRAMES
+@check:
+    pla
+    pha
+    cmp DISPGFX_FRAMES
+    beq @poll
+    pla
+    rts
+
+
 ; ============================================================
 ; dispgfx_update_hw_cursor — send SET_CURSOR command to emulator
 ;   Uses DISPGFX_CURS_COL / DISPGFX_CURS_ROW shadow registers.
@@ -164,7 +169,10 @@ dispgfx_update_hw_cursor:
 ; Out: A clobbered; Y preserved
 ;
 ; Handles printable chars, CR ($0D), LF ($0A), backspace ($08).
-; Wraps at column 40, scrolls at row 30.
+; Wraps after the last column and scrolls after the last row of the
+; current text geometry (hardware scroll, see _scroll_up).  VRAM is a
+; ring of rows, so the write pointers are recomputed on every row
+; change; within a row VRAM_WPTR and CRAM_WPTR move together.
 ; Does NOT update the hardware cursor — putsg / getsg do that
 ; once after a full string/line for efficiency.
 ; ============================================================
@@ -189,17 +197,20 @@ putcg:
     ldy #$00
     sta (DISPGFX_VRAM_WPTR),y  ; write char to VRAM at write-pointer
 
-    ; Advance VRAM write pointer by 1
+    ; Advance VRAM and CRAM write pointers by 1
     inc DISPGFX_VRAM_WPTR
     bne :+
     inc DISPGFX_VRAM_WPTR+1
+:   inc DISPGFX_CRAM_WPTR
+    bne :+
+    inc DISPGFX_CRAM_WPTR+1
 :
 
     ; Advance cursor column
     inc DISPGFX_CURS_COL
     lda DISPGFX_CURS_COL
-    cmp #DISPGFX_COLS
-    bcc @done                   ; col < 40 → no wrap needed
+    cmp DISPGFX_TEXT_COLS
+    bcc @done                   ; col < cols → no wrap needed
 
     ; ── Wrap to next line ──────────────────────────────────────
     lda #$00
@@ -207,35 +218,16 @@ putcg:
     jmp @advance_row
 
 @newline:
-    ; Advance WPTR by (COLS - current_col) to reach the next row boundary
-    sec
-    lda #DISPGFX_COLS
-    sbc DISPGFX_CURS_COL        ; A = bytes to skip
-    clc
-    adc DISPGFX_VRAM_WPTR
-    sta DISPGFX_VRAM_WPTR
-    bcc :+
-    inc DISPGFX_VRAM_WPTR+1
-:
-    ; Also advance CRAM pointer by the same amount
-    sec
-    lda #DISPGFX_COLS
-    sbc DISPGFX_CURS_COL
-    clc
-    adc DISPGFX_CRAM_WPTR
-    sta DISPGFX_CRAM_WPTR
-    bcc :+
-    inc DISPGFX_CRAM_WPTR+1
-:
     lda #$00
     sta DISPGFX_CURS_COL
 
 @advance_row:
     inc DISPGFX_CURS_ROW
     lda DISPGFX_CURS_ROW
-    cmp #DISPGFX_ROWS
-    bcc @done                   ; row < 30 → ok
+    cmp DISPGFX_TEXT_ROWS
+    bcc :+                      ; row < rows → ok
     jsr _scroll_up
+:   jsr _dispgfx_set_wptr       ; new row may wrap around the VRAM ring
     jmp @done
 
 @backspace:
@@ -245,11 +237,15 @@ putcg:
 
     dec DISPGFX_CURS_COL
 
-    ; Decrement VRAM write pointer
+    ; Decrement VRAM and CRAM write pointers
     lda DISPGFX_VRAM_WPTR
     bne :+
     dec DISPGFX_VRAM_WPTR+1
 :   dec DISPGFX_VRAM_WPTR
+    lda DISPGFX_CRAM_WPTR
+    bne :+
+    dec DISPGFX_CRAM_WPTR+1
+:   dec DISPGFX_CRAM_WPTR
 
     ; Write space at the (now current) position
     lda #$20
@@ -265,165 +261,178 @@ putcg:
 
 
 ; ============================================================
-; _scroll_up — shift the entire screen up by one row
+; _scroll_up — scroll the screen up by one row
 ;
-; Copies VRAM[row 1..29] → VRAM[row 0..28]  (1160 bytes)
-; Clears VRAM row 29 (40 bytes → spaces)
-; Does the same for CRAM (colour attributes).
-; Sets cursor row = 29, recomputes VRAM/CRAM write pointers.
+; The display treats VRAM/CRAM as a ring of DISPGFX_TEXT_ROWS rows
+; starting at DISPGFX_SCROLL_ROW. SCROLL_UP advances the start row and
+; blanks the row that comes into view, so no bytes move on the 6502.
+; Sets cursor row = last row; the caller recomputes the write pointers.
 ;
-; Clobbers: A, X, Y.  Saves/restores STRPTR and CMPPTR.
+; Clobbers: A.
 ; ============================================================
 _scroll_up:
-    ; ── Save STRPTR and CMPPTR (caller may be using them) ─────
-    lda STRPTR
-    pha
-    lda STRPTR+1
-    pha
-    lda CMPPTR
-    pha
-    lda CMPPTR+1
-    pha
-
-    ; ============ Scroll VRAM ============
-    ; Source = VRAM_BASE + 40 (row 1)
-    lda #<(DISPGFX_VRAM_BASE + DISPGFX_COLS)
-    sta STRPTR
-    lda #>(DISPGFX_VRAM_BASE + DISPGFX_COLS)
-    sta STRPTR+1
-    ; Dest = VRAM_BASE (row 0)
-    lda #<DISPGFX_VRAM_BASE
-    sta CMPPTR
-    lda #>DISPGFX_VRAM_BASE
-    sta CMPPTR+1
+    jsr dispgfx_wait_idle
+    lda #$01
+    sta DISPGFX_DATA_REG        ; DATA low = 1 row
+    lda #DISPGFX_DEFAULT_ATTR
+    sta DISPGFX_DATA_REG+1      ; DATA high = attr for the new row
+    lda #DISPGFX_CMD_SCROLL_UP
+    sta DISPGFX_CMD_REG
 
-    ; Copy 1160 bytes = 4 full pages (1024) + 136 remaining
-    ldx #$04
-@vram_page:
-    ldy #$00
-@vram_byte:
-    lda (STRPTR),y
-    sta (CMPPTR),y
-    iny
-    bne @vram_byte
-    inc STRPTR+1
-    inc CMPPTR+1
-    dex
-    bne @vram_page
+    ; Mirror the start row: (SCROLL_ROW + 1) mod rows
+    inc DISPGFX_SCROLL_ROW
+    lda DISPGFX_SCROLL_ROW
+    cmp DISPGFX_TEXT_ROWS
+    bcc :+
+    lda #$00
+    sta DISPGFX_SCROLL_ROW
+:
+    lda DISPGFX_TEXT_ROWS
+    sec
+    sbc #$01
+    sta DISPGFX_CURS_ROW
+    jsr dispgfx_wait_idle       ; new row is blank before we write it
+    rts
 
-    ; Copy remaining 136 bytes
-    ldy #$00
-@vram_tail:
-    cpy #136
-    beq @vram_clear_last
-    lda (STRPTR),y
-    sta (CMPPTR),y
-    iny
-    bne @vram_tail              ; always taken (Y < 136 < 256)
 
-@vram_clear_last:
-    ; CMPPTR now points 1024 bytes past VRAM_BASE.
-    ; Last row starts at VRAM_BASE + 1160 = VRAM_BASE + 1024 + 136.
-    ; Advance CMPPTR by 136 to reach it.
+; ============================================================
+; _dispgfx_set_wptr — point VRAM/CRAM write pointers at the cursor
+;
+; ring row = (CURS_ROW + SCROLL_ROW) mod rows
+; WPTR     = buffer + ring row * cols + CURS_COL
+; (row * 80 is the row * 40 table entry doubled)
+;
+; Clobbers: A, Y.
+; ============================================================
+_dispgfx_set_wptr:
     clc
-    lda CMPPTR
-    adc #136
-    sta CMPPTR
-    lda CMPPTR+1
-    adc #$00
-    sta CMPPTR+1
-
-    lda #$20                    ; space
-    ldy #$00
-@vram_clr:
-    sta (CMPPTR),y
-    iny
-    cpy #DISPGFX_COLS
-    bne @vram_clr
-
-    ; ============ Scroll CRAM ============
-    lda #<(DISPGFX_CRAM_BASE + DISPGFX_COLS)
-    sta STRPTR
-    lda #>(DISPGFX_CRAM_BASE + DISPGFX_COLS)
-    sta STRPTR+1
-    lda #<DISPGFX_CRAM_BASE
-    sta CMPPTR
-    lda #>DISPGFX_CRAM_BASE
-    sta CMPPTR+1
+    lda DISPGFX_CURS_ROW
+    adc DISPGFX_SCROLL_ROW
+    cmp DISPGFX_TEXT_ROWS
+    bcc :+
+    sbc DISPGFX_TEXT_ROWS       ; carry set by cmp
+:   asl                         ; word index into _dispgfx_row_offs
+    tay
 
-    ldx #$04
-@cram_page:
-    ldy #$00
-@cram_byte:
-    lda (STRPTR),y
-    sta (CMPPTR),y
-    iny
-    bne @cram_byte
-    inc STRPTR+1
-    inc CMPPTR+1
-    dex
-    bne @cram_page
+    lda _dispgfx_row_offs,y     ; VRAM_WPTR = ring row * 40
+    sta DISPGFX_VRAM_WPTR
+    lda _dispgfx_row_offs+1,y
+    sta DISPGFX_VRAM_WPTR+1
+    lda DISPGFX_TEXT_COLS
+    cmp #DISPGFX_COLS
+    beq :+
+    asl DISPGFX_VRAM_WPTR       ; 80 columns: ring row * 80
+    rol DISPGFX_VRAM_WPTR+1
+:
+    clc                         ; VRAM_WPTR += col
+    lda DISPGFX_VRAM_WPTR
+    adc DISPGFX_CURS_COL
+    sta DISPGFX_VRAM_WPTR
+    bcc :+
+    inc DISPGFX_VRAM_WPTR+1
+:
+    clc                         ; CRAM_WPTR = CRAM + offset
+    lda DISPGFX_VRAM_WPTR
+    adc DISPGFX_CRAM_PTR
+    sta DISPGFX_CRAM_WPTR
+    lda DISPGFX_VRAM_WPTR+1
+    adc DISPGFX_CRAM_PTR+1
+    sta DISPGFX_CRAM_WPTR+1
 
-    ldy #$00
-@cram_tail:
-    cpy #136
-    beq @cram_clear_last
-    lda (STRPTR),y
-    sta (CMPPTR),y
-    iny
-    bne @cram_tail
+    clc                         ; VRAM_WPTR += VRAM
+    lda DISPGFX_VRAM_WPTR
+    adc DISPGFX_VRAM_PTR
+    sta DISPGFX_VRAM_WPTR
+    lda DISPGFX_VRAM_WPTR+1
+    adc DISPGFX_VRAM_PTR+1
+    sta DISPGFX_VRAM_WPTR+1
+    rts
 
-@cram_clear_last:
-    clc
-    lda CMPPTR
-    adc #136
-    sta CMPPTR
-    lda CMPPTR+1
-    adc #$00
-    sta CMPPTR+1
+_dispgfx_row_offs:
+    .repeat DISPGFX_MAX_ROWS, I
+    .word I * DISPGFX_COLS
+    .endrepeat
 
-    lda #DISPGFX_DEFAULT_ATTR   ; default colour
-    ldy #$00
-@cram_clr:
-    sta (CMPPTR),y
-    iny
-    cpy #DISPGFX_COLS
-    bne @cram_clr
 
-    ; ── Restore STRPTR / CMPPTR ───────────────────────────────
-    pla
-    sta CMPPTR+1
-    pla
-    sta CMPPTR
-    pla
-    sta STRPTR+1
+; ============================================================
+; dispgfx_set_mode — select a text geometry and clear the screen
+;
+; In:  A = DISPGFX_MODE_TEXT (40×30), DISPGFX_MODE_TEXT80X25 or
+;          DISPGFX_MODE_TEXT80X50
+; Out: A, Y clobbered
+;
+; 40×30 uses the monitor buffers at DISPGFX_VRAM_BASE/CRAM_BASE;
+; the 80-column modes use DISPGFX_VRAM80_BASE/CRAM80_BASE. The
+; geometry is read back from the device, so putcg and _scroll_up
+; follow it. Cursor goes to (0,0), screen is cleared.
+; ============================================================
+dispgfx_set_mode:
+    pha
+    jsr dispgfx_wait_idle
     pla
-    sta STRPTR
+    pha
+    cmp #DISPGFX_MODE_TEXT
+    bne @wide
+    lda #<DISPGFX_VRAM_BASE
+    sta DISPGFX_VRAM_PTR
+    lda #>DISPGFX_VRAM_BASE
+    sta DISPGFX_VRAM_PTR+1
+    lda #<DISPGFX_CRAM_BASE
+    sta DISPGFX_CRAM_PTR
+    lda #>DISPGFX_CRAM_BASE
+    sta DISPGFX_CRAM_PTR+1
+    jmp @bases
+@wide:
+    lda #<DISPGFX_VRAM80_BASE
+    sta DISPGFX_VRAM_PTR
+    lda #>DISPGFX_VRAM80_BASE
+    sta DISPGFX_VRAM_PTR+1
+    lda #<DISPGFX_CRAM80_BASE
+    sta DISPGFX_CRAM_PTR
+    lda #>DISPGFX_CRAM80_BASE
+    sta DISPGFX_CRAM_PTR+1
+
+@bases:
+    ; ── Tell emulator where VRAM / CRAM live ──────────────────
+    lda DISPGFX_VRAM_PTR
+    sta DISPGFX_DATA_REG
+    lda DISPGFX_VRAM_PTR+1
+    sta DISPGFX_DATA_REG+1
+    lda #DISPGFX_CMD_SET_VRAM       ; NOTE: #immediate
+    sta DISPGFX_CMD_REG
+    jsr dispgfx_wait_idle
 
-    ; ── Row = 29, col unchanged.  Recompute write pointers. ──
-    lda #(DISPGFX_ROWS - 1)
-    sta DISPGFX_CURS_ROW
+    lda DISPGFX_CRAM_PTR
+    sta DISPGFX_DATA_REG
+    lda DISPGFX_CRAM_PTR+1
+    sta DISPGFX_DATA_REG+1
+    lda #DISPGFX_CMD_SET_CRAM
+    sta DISPGFX_CMD_REG
+    jsr dispgfx_wait_idle
 
-    ; VRAM_WPTR = VRAM_BASE + 29*40 + col
-    ;   29*40 = 1160 = $0488
-    clc
-    lda #<(DISPGFX_VRAM_BASE + 1160)
-    adc DISPGFX_CURS_COL
-    sta DISPGFX_VRAM_WPTR
-    lda #>(DISPGFX_VRAM_BASE + 1160)
-    adc #$00
-    sta DISPGFX_VRAM_WPTR+1
+    ; ── Switch mode; DATA comes back as cols / rows ───────────
+    pla
+    sta DISPGFX_DATA_REG
+    lda #DISPGFX_CMD_SET_MODE
+    sta DISPGFX_CMD_REG
+    jsr dispgfx_wait_idle
+    lda DISPGFX_DATA_REG
+    sta DISPGFX_TEXT_COLS
+    lda DISPGFX_DATA_REG+1
+    sta DISPGFX_TEXT_ROWS
 
-    ; CRAM_WPTR = CRAM_BASE + 29*40 + col
-    clc
-    lda #<(DISPGFX_CRAM_BASE + 1160)
-    adc DISPGFX_CURS_COL
-    sta DISPGFX_CRAM_WPTR
-    lda #>(DISPGFX_CRAM_BASE + 1160)
-    adc #$00
-    sta DISPGFX_CRAM_WPTR+1
+    ; ── Clear screen ──────────────────────────────────────────
+    lda #DISPGFX_CMD_CLEAR
+    sta DISPGFX_CMD_REG
+    jsr dispgfx_wait_idle
 
-    rts
+    ; ── Cursor at (0,0), screen not scrolled ──────────────────
+    lda #$00
+    sta DISPGFX_CURS_ROW
+    sta DISPGFX_CURS_COL
+    sta DISPGFX_SCROLL_ROW
+    jsr _dispgfx_set_wptr
+    jmp dispgfx_update_hw_cursor
 
 
 ; ============================================================
@@ -595,25 +604,26 @@ _floppy_wait_cmd:
 
 
 ; ============================================================
-; floppy_read — load N sectors from floppy into RAM
+; _floppy_setup — program DMA address, LBA and sector count
 ;
-; In:  A       = number of sectors to read (1–255)
-;      Y       = starting LBA sector number (0–255)
-;      STRPTR  = 16-bit DMA destination address
+; In:  A       = number of sectors (1–127)
+;      X       = starting LBA high byte
+;      Y       = starting LBA low byte
+;      STRPTR  = 16-bit DMA address
 ;
-; Out: Carry clear on success, Carry set on error.
-;      A, X, Y clobbered.  STRPTR advanced past last byte loaded.
+; Out: CMPPTR = sector count.  A, Y clobbered.
 ; ============================================================
-floppy_read:
+_floppy_setup:
     sta CMPPTR
-    sty CMPPTR+1
+    stx CMPPTR+1
+    tya
+    pha                     ; park LBA low — DATA reg is needed for DMA first
 
     jsr _floppy_wait_idle
     lda #FLOPPY_CMD_RESET
     sta FLOPPY_CMD_REG
     jsr _floppy_wait_cmd
 
-@read_loop:
     lda STRPTR
     sta FLOPPY_DATA_REG
     lda STRPTR+1
@@ -622,115 +632,499 @@ floppy_read:
     sta FLOPPY_CMD_REG
     jsr _floppy_wait_cmd
 
+    pla
+    sta FLOPPY_DATA_REG     ; LBA low
     lda CMPPTR+1
-    sta FLOPPY_DATA_REG
+    sta FLOPPY_DATA_REG+1   ; LBA high
     lda #FLOPPY_CMD_STORE_LBA
     sta FLOPPY_CMD_REG
     jsr _floppy_wait_cmd
 
-    lda #$00
+    lda CMPPTR
+    sta FLOPPY_DATA_REG
+    lda #FLOPPY_CMD_SET_COUNT
+    sta FLOPPY_CMD_REG
+    jsr _floppy_wait_cmd
+    rts
+
+
+; ============================================================
+; _floppy_drive_bit — FLOPPY_DONE bit of the selected drive
+;
+; Out: A = 1 << drive.  Y clobbered.
+; ============================================================
+_floppy_drive_bit:
+    lda FLOPPY_DRIVE_REG
+    and #(FLOPPY_MAX_DRIVES - 1)
+    tay
+    lda _floppy_bits,y
+    rts
+
+_floppy_bits:
+    .byte $01, $02, $04, $08
+
+
+; ============================================================
+; _floppy_start — issue an IRQ-completing command, don't wait
+;
+; Clears the selected drive's FLOPPY_DONE bit, writes the command
+; and leaves IRQs enabled so the completion can be taken while
+; the caller does other work (including on another drive).
+;
+; In:  A = command.  Out: A, Y clobbered.
+; ============================================================
+_floppy_start:
+    pha
+    jsr _floppy_drive_bit
+    eor #$FF
+    sei                     ; FLOPPY_DONE is shared with the IRQ handler
+    and FLOPPY_DONE
     sta FLOPPY_DONE
-    cli
-    lda #FLOPPY_CMD_READ_SECTOR
+    pla
     sta FLOPPY_CMD_REG
-@read_wait_irq:
-    lda FLOPPY_DONE
-    beq @read_wait_irq
-    sei
+    cli
+    rts
 
-    lda FLOPPY_STATUS_REG
-    and #FLOPPY_STATUS_ERROR
-    bne @read_error
 
+; ============================================================
+; _floppy_advance — STRPTR += CMPPTR sectors (512 B each)
+;
+; count × 2 pages fits in one byte because count < 128.
+; ============================================================
+_floppy_advance:
+    lda CMPPTR
+    asl a                   ; 512-byte sectors → 2 pages each
     clc
-    lda STRPTR
-    adc #$00
-    sta STRPTR
-    lda STRPTR+1
-    adc #$02
+    adc STRPTR+1
     sta STRPTR+1
+    rts
 
-    inc CMPPTR+1
-    dec CMPPTR
-    bne @read_loop
+_floppy_bad_count:
+    sec
+    rts
 
+
+; ============================================================
+; _floppy_transfer — issue a MULTI command and wait for its IRQ
+;
+; In:  A       = FLOPPY_CMD_READ_MULTI or FLOPPY_CMD_WRITE_MULTI
+;      CMPPTR  = sector count (from _floppy_setup)
+;
+; Out: Carry clear on success, Carry set on error.
+;      STRPTR advanced by count × 512 on success.  A, Y clobbered.
+; ============================================================
+_floppy_transfer:
+    jsr _floppy_start
+    jsr floppy_wait
+    bcs @error
+    jsr _floppy_advance
     clc
+@error:
     rts
 
-@read_error:
-    sec
+
+; ============================================================
+; floppy_select — direct the floppy calls below at one drive
+;
+; Takes effect immediately; a transfer already started on the
+; previous drive keeps running.  Drives without an image fail
+; every command with Carry set.
+;
+; In:  A = drive (0 = A:, 1 = B:, ... FLOPPY_MAX_DRIVES-1)
+; ============================================================
+floppy_select:
+    sta FLOPPY_DRIVE_REG
+    rts
+
+
+; ============================================================
+; floppy_wait — wait for the selected drive's transfer to end
+;
+; Pairs with floppy_start_read / floppy_start_write.  Returns
+; with IRQs disabled.
+;
+; Out: Carry clear on success, Carry set on error.  A, Y clobbered.
+; ============================================================
+floppy_wait:
+    jsr _floppy_drive_bit
+    cli                     ; a previous floppy_wait may have masked IRQs
+@wait_irq:
+    bit FLOPPY_DONE
+    beq @wait_irq
+    sei
+
+    lda FLOPPY_STATUS_REG
+    and #FLOPPY_STATUS_ERROR
+    cmp #$01                ; C = 1 iff ERROR was set
     rts
 
 
+; ============================================================
+; floppy_read — load N sectors from floppy into RAM
+;
+; One DMA and one completion IRQ for the whole run of sectors.
+;
+; In:  A       = number of sectors to read (1–127)
+;      X       = starting LBA high byte
+;      Y       = starting LBA low byte  (LBA 0–2879)
+;      STRPTR  = 16-bit DMA destination address
+;
+; Out: Carry clear on success, Carry set on error (including a
+;      count of 128 or more).
+;      A, X, Y clobbered.  STRPTR advanced past last byte loaded.
+; ============================================================
+floppy_read:
+    cmp #$80
+    bcs _floppy_bad_count
+    jsr _floppy_setup
+    lda #FLOPPY_CMD_READ_MULTI
+    jmp _floppy_transfer
+
+
 ; ============================================================
 ; floppy_write — write N sectors from RAM to floppy
 ;
-; In:  A       = number of sectors to write (1–255)
-;      Y       = starting LBA sector number (0–255)
+; In:  A       = number of sectors to write (1–127)
+;      X       = starting LBA high byte
+;      Y       = starting LBA low byte  (LBA 0–2879)
 ;      STRPTR  = 16-bit DMA source address
 ;
-; Out: Carry clear on success, Carry set on error.
+; Out: Carry clear on success, Carry set on error (as floppy_read).
+;      A, X, Y clobbered.  STRPTR advanced past last byte written.
 ; ============================================================
 floppy_write:
-    sta CMPPTR
-    sty CMPPTR+1
+    cmp #$80
+    bcs _floppy_bad_count
+    jsr _floppy_setup
+    lda #FLOPPY_CMD_WRITE_MULTI
+    jmp _floppy_transfer
+
+
+; ============================================================
+; floppy_start_read / floppy_start_write — begin a transfer on
+; the selected drive and return without waiting for it
+;
+; Same inputs as floppy_read / floppy_write.  STRPTR is advanced
+; at once; call floppy_wait (with the same drive selected) for the
+; result.  IRQs are left enabled.  Starting a transfer on each of
+; two drives lets both run at the same time.
+;
+; Out: Carry clear if started, Carry set (nothing started) for a
+;      count of 128 or more.  A, X, Y clobbered.
+; ============================================================
+floppy_start_read:
+    cmp #$80
+    bcs _floppy_bad_count
+    jsr _floppy_setup
+    lda #FLOPPY_CMD_READ_MULTI
+    jmp _floppy_start_advance
+
+floppy_start_write:
+    cmp #$80
+    bcs _floppy_bad_count
+    jsr _floppy_setup
+    lda #FLOPPY_CMD_WRITE_MULTI
+_floppy_start_advance:
+    jsr _floppy_start
+    jsr _floppy_advance
+    clc
+    rts
+
 
+; ============================================================
+; floppy_flush — commit written sectors to the disk image
+;
+; Writes land in the host page cache; this forces them out.
+; No IRQ: completes when CMD returns to NO_CMD.
+;
+; Out: Carry clear on success, Carry set on error.  A clobbered.
+; ============================================================
+floppy_flush:
     jsr _floppy_wait_idle
-    lda #FLOPPY_CMD_RESET
+    lda #FLOPPY_CMD_FLUSH
     sta FLOPPY_CMD_REG
     jsr _floppy_wait_cmd
+    lda FLOPPY_STATUS_REG
+    and #FLOPPY_STATUS_ERROR
+    cmp #$01                ; C = 1 iff ERROR was set
+    rts
 
-@write_loop:
-    lda STRPTR
+
+; ============================================================
+; floppy_queue_init — register an empty command-queue ring
+;
+; The ring is FLOPPY_Q_DESC + FLOPPY_QUEUE_SLOTS × FLOPPY_QDESC_SIZE
+; bytes (130).  Post a descriptor by filling slot HEAD with status 0,
+; then advancing HEAD modulo FLOPPY_QUEUE_SLOTS (15 outstanding
+; at most: HEAD = TAIL means empty).
+;
+; In:  A = ring address low byte
+;      X = ring address high byte
+;
+; Out: A, Y, CMPPTR clobbered.
+; ============================================================
+floppy_queue_init:
+    sta CMPPTR
+    stx CMPPTR+1
+    jsr _floppy_wait_idle
+
+    lda #$00
+    ldy #FLOPPY_Q_HEAD
+    sta (CMPPTR),y
+    ldy #FLOPPY_Q_TAIL
+    sta (CMPPTR),y
+
+    lda CMPPTR
     sta FLOPPY_DATA_REG
-    lda STRPTR+1
+    lda CMPPTR+1
     sta FLOPPY_DATA_REG+1
-    lda #FLOPPY_CMD_SET_DMA_ADDR
+    lda #FLOPPY_CMD_SET_QUEUE
     sta FLOPPY_CMD_REG
-    jsr _floppy_wait_cmd
+    jmp _floppy_wait_cmd
 
-    lda CMPPTR+1
-    sta FLOPPY_DATA_REG
-    lda #FLOPPY_CMD_STORE_LBA
-    sta FLOPPY_CMD_REG
-    jsr _floppy_wait_cmd
 
+; ============================================================
+; floppy_queue_kick — run every posted descriptor
+;
+; The controller reorders the batch by cylinder (elevator) and
+; writes each descriptor's status as it completes; one IRQ at the
+; end.  TAIL equals HEAD on return.
+;
+; Out: Carry set if no ring was registered, clear otherwise.
+;      A, Y clobbered.
+; ============================================================
+floppy_queue_kick:
+    jsr _floppy_wait_idle
+    lda #FLOPPY_CMD_QUEUE_KICK
+    jsr _floppy_start
+    jmp floppy_wait
+
+
+; ============================================================
+; _hdd_wait_idle / _hdd_wait_cmd — same contract as the floppy
+; versions, on the hard disk registers.
+; ============================================================
+_hdd_wait_idle:
+    lda HDD_STATUS_REG
+    and #HDD_STATUS_BUSY
+    bne _hdd_wait_idle
+    rts
+
+_hdd_wait_cmd:
+    lda HDD_CMD_REG
+    bne _hdd_wait_cmd
+    lda HDD_STATUS_REG
+    and #HDD_STATUS_BUSY
+    bne _hdd_wait_cmd
+    rts
+
+
+; ============================================================
+; _hdd_setup — program DMA address, 32-bit LBA and sector count
+;
+; In:  A       = number of sectors (1–127)
+;      X       = low byte of the address of a 4-byte LE LBA
+;      Y       = high byte of that address
+;      STRPTR  = 16-bit DMA address
+;
+; Out: CMPPTR = sector count (for _hdd_transfer).  A, Y clobbered.
+; ============================================================
+_hdd_setup:
+    pha
+    stx CMPPTR
+    sty CMPPTR+1
+    jsr _hdd_wait_idle
+
+    lda #HDD_CMD_RESET
+    sta HDD_CMD_REG
+    jsr _hdd_wait_cmd
+
+    lda STRPTR
+    sta HDD_DATA_REG
+    lda STRPTR+1
+    sta HDD_DATA_REG+1
+    lda #HDD_CMD_SET_DMA_ADDR
+    sta HDD_CMD_REG
+    jsr _hdd_wait_cmd
+
+    ldy #$03
+@copy_lba:
+    lda (CMPPTR),y
+    sta HDD_DATA_REG,y
+    dey
+    bpl @copy_lba
+    lda #HDD_CMD_STORE_LBA
+    sta HDD_CMD_REG
+    jsr _hdd_wait_cmd
+
+    pla
+    sta CMPPTR
+    sta HDD_DATA_REG
+    lda #HDD_CMD_SET_COUNT
+    sta HDD_CMD_REG
+    jmp _hdd_wait_cmd
+
+
+; ============================================================
+; _hdd_transfer — issue a MULTI command and wait for its IRQ
+;
+; In:  A       = HDD_CMD_READ_MULTI or HDD_CMD_WRITE_MULTI
+;      CMPPTR  = sector count (from _hdd_setup)
+;
+; Out: Carry clear on success, Carry set on error.
+;      STRPTR advanced by count × 512 on success.  A clobbered.
+;      count × 2 pages fits in one byte because count < 128.
+; ============================================================
+_hdd_transfer:
+    pha
     lda #$00
-    sta FLOPPY_DONE
+    sta HDD_DONE
+    pla
     cli
-    lda #FLOPPY_CMD_WRITE_SECTOR
-    sta FLOPPY_CMD_REG
-@write_wait_irq:
-    lda FLOPPY_DONE
-    beq @write_wait_irq
+    sta HDD_CMD_REG
+@wait_irq:
+    lda HDD_DONE
+    beq @wait_irq
     sei
 
-    lda FLOPPY_STATUS_REG
-    and #FLOPPY_STATUS_ERROR
-    bne @write_error
+    lda HDD_STATUS_REG
+    and #HDD_STATUS_ERROR
+    bne @error
 
+    lda CMPPTR
+    asl a                   ; 512-byte sectors → 2 pages each
     clc
-    lda STRPTR
-    adc #$00
-    sta STRPTR
-    lda STRPTR+1
-    adc #$02
+    adc STRPTR+1
     sta STRPTR+1
 
-    inc CMPPTR+1
-    dec CMPPTR
-    bne @write_loop
-
     clc
     rts
 
-@write_error:
+@error:
+_hdd_bad_count:
     sec
     rts
 
 
+; ============================================================
+; hdd_read — load N sectors from the hard disk into RAM
+;
+; In:  A       = number of sectors to read (1–127)
+;      X/Y     = address of a 4-byte LE starting LBA (X = low byte)
+;      STRPTR  = 16-bit DMA destination address
+;
+; Out: Carry clear on success, Carry set on error (no disk,
+;      LBA past the end, count of 128 or more).  A, Y clobbered.
+;      STRPTR advanced.
+; ============================================================
+hdd_read:
+    cmp #$80
+    bcs _hdd_bad_count
+    jsr _hdd_setup
+    lda #HDD_CMD_READ_MULTI
+    jmp _hdd_transfer
+
+
+; ============================================================
+; hdd_write — write N sectors from RAM to the hard disk
+;
+; In:  A       = number of sectors to write (1–127)
+;      X/Y     = address of a 4-byte LE starting LBA (X = low byte)
+;      STRPTR  = 16-bit DMA source address
+;
+; Out: Carry clear on success, Carry set on error (as hdd_read).
+;      A, Y clobbered.  STRPTR advanced.
+; ============================================================
+hdd_write:
+    cmp #$80
+    bcs _hdd_bad_count
+    jsr _hdd_setup
+    lda #HDD_CMD_WRITE_MULTI
+    jmp _hdd_transfer
+
+
+; ============================================================
+; hdd_flush — commit written sectors to the disk image
+;
+; Out: Carry clear on success, Carry set on error.  A clobbered.
+; ============================================================
+hdd_flush:
+    jsr _hdd_wait_idle
+    lda #HDD_CMD_FLUSH
+    sta HDD_CMD_REG
+    jsr _hdd_wait_cmd
+    lda HDD_STATUS_REG
+    and #HDD_STATUS_ERROR
+    cmp #$01                ; C = 1 iff ERROR was set
+    rts
+
+
+; ============================================================
+; hdd_identify — read the disk size
+;
+; In:  X/Y     = address of a 4-byte buffer (X = low byte)
+;
+; Out: Buffer = 32-bit LE sector count (0 = no disk attached).
+;      A, Y, CMPPTR clobbered.
+; ============================================================
+hdd_identify:
+    stx CMPPTR
+    sty CMPPTR+1
+    jsr _hdd_wait_idle
+    lda #HDD_CMD_IDENTIFY
+    sta HDD_CMD_REG
+    jsr _hdd_wait_cmd
+    ldy #$03
+@copy_size:
+    lda HDD_DATA_REG,y
+    sta (CMPPTR),y
+    dey
+    bpl @copy_size
+    rts
+
+
+; ============================================================
+; timer_delay — wait a number of milliseconds
+;
+; Runs the timer periodically at one expiry per millisecond and
+; sleeps on its IRQs, so the delay is exact in emulated time
+; whatever the loop costs.  IRQs are left masked on return.
+;
+; In:  A       = milliseconds (0 returns at once)
+;
+; Out: A, X clobbered.  The timer is stopped.
+; ============================================================
+timer_delay:
+    tax
+    beq @done
+    lda #<TIMER_CYCLES_PER_MS
+    sta TIMER_COUNT_REG
+    lda #>TIMER_CYCLES_PER_MS
+    sta TIMER_COUNT_REG+1
+    lda #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC | TIMER_CTRL_IRQ)
+    sta TIMER_CTRL_REG
+    cli
+@tick:
+    lda TIMER_TICKS
+@wait:
+    cmp TIMER_TICKS
+    beq @wait               ; spin until the IRQ handler counts an expiry
+    dex
+    bne @tick
+    sei
+    lda #$00
+    sta TIMER_CTRL_REG
+@done:
+    rts
+
+
 ; ============================================================
 ; IRQ handler
+;
+; Dispatches on the interrupt controller's CAUSE register: one
+; load picks the handler of the highest-priority pending source,
+; which acknowledges its source and comes back here for the next
+; one until CAUSE reads IRQC_CAUSE_NONE.
 ; ============================================================
 irq:
     pha
@@ -739,25 +1133,80 @@ irq:
     tya
     pha
 
+_irq_dispatch:
+    ldx IRQC_CAUSE_REG      ; 2 × source number
+    lda _irq_vectors+1,x
+    pha
+    lda _irq_vectors,x
+    pha
+    rts                     ; "return" into the handler
+
+; Handler address - 1 per cause, for the rts above
+_irq_vectors:
+    .word _irq_timer-1      ; IRQC_TIMER
+    .word _irq_kbd-1        ; IRQC_KBD
+    .word _irq_hdd-1        ; IRQC_HDD
+    .word _irq_floppy-1     ; IRQC_FLOPPY
+    .word _irq_dispgfx-1    ; IRQC_DISPGFX
+    .word _irq_done-1       ; unused sources
+    .word _irq_done-1
+    .word _irq_done-1
+    .word _irq_done-1       ; IRQC_CAUSE_NONE
+
+_irq_timer:
+    ; ── Timer: expiry latch, cleared by this read ─────────────
+    lda #IRQC_TIMER
+    sta IRQC_ACK_REG
+    lda TIMER_STATUS_REG
+    and #TIMER_STATUS_EXPIRED
+    beq _irq_dispatch
+    inc TIMER_TICKS
+    jmp _irq_dispatch
+
+_irq_kbd:
     ; ── Keyboard ──────────────────────────────────────────────
+    lda #IRQC_KBD
+    sta IRQC_ACK_REG
     lda KBD_DATA_REG
-    beq @check_floppy
+    beq _irq_dispatch
     sta KBD_LAST
     lda #$00
     sta KBD_DATA_REG        ; ACK
-
-@check_floppy:
-    ; ── Floppy ────────────────────────────────────────────────
-    lda FLOPPY_STATUS_REG
-    and #FLOPPY_STATUS_IRQ
-    beq @irq_done
-    lda FLOPPY_STATUS_REG
-    and #($FF - FLOPPY_STATUS_IRQ)
-    sta FLOPPY_STATUS_REG
+    jmp _irq_dispatch
+
+_irq_hdd:
+    ; ── Hard disk ─────────────────────────────────────────────
+    lda #IRQC_HDD
+    sta IRQC_ACK_REG
+    lda HDD_STATUS_REG
+    and #($FF - HDD_STATUS_IRQ)
+    sta HDD_STATUS_REG
     lda #$01
+    sta HDD_DONE
+    jmp _irq_dispatch
+
+_irq_floppy:
+    ; ── Floppy: one pending bit per drive ─────────────────────
+    lda #IRQC_FLOPPY
+    sta IRQC_ACK_REG
+    lda FLOPPY_IRQ_REG
+    beq _irq_dispatch
+    sta FLOPPY_IRQ_REG      ; ACK exactly the drives we saw
+    ora FLOPPY_DONE
     sta FLOPPY_DONE
+    jmp _irq_dispatch
+
+_irq_dispgfx:
+    ; ── Display: VBLANK latch, cleared by this read ───────────
+    lda #IRQC_DISPGFX
+    sta IRQC_ACK_REG
+    lda DISPGFX_STATUS_REG
+    and #DISPGFX_STATUS_VBLANK
+    beq _irq_dispatch
+    inc DISPGFX_FRAMES
+    jmp _irq_dispatch
 
-@irq_done:
+_irq_done:
     pla
     tay
     pla
@@ -788,7 +1237,7 @@ msg_hanging:
 ; ============================================================
 ; DEVICE TABLE at $FF00
 ;
-; 16 bytes — eight 16-bit LE pointers to actual device registers.
+; 28 bytes — fourteen 16-bit LE pointers to actual device registers.
 ; The C emulator reads these at startup to learn where devices are:
 ;
 ;   $FF00–$FF01  floppy STATUS reg    → $0200
@@ -799,6 +1248,12 @@ msg_hanging:
 ;   $FF0A–$FF0B  dispgfx CMD reg      → $0206
 ;   $FF0C–$FF0D  dispgfx DATA reg     → $0207
 ;   $FF0E–$FF0F  dispgfx STATUS reg   → $0209
+;   $FF10–$FF11  hdd STATUS reg       → $7FF0
+;   $FF12–$FF13  hdd CMD reg          → $7FF1
+;   $FF14–$FF15  hdd DATA reg         → $7FF2
+;   $FF16–$FF17  floppy DRIVE reg     → $7FF6
+;   $FF18–$FF19  timer CTRL reg       → $7FF8
+;   $FF1A–$FF1B  irqc PENDING reg     → $7FFC
 ; ============================================================
 .segment "DEVTABLE"
     .word FLOPPY_STATUS_REG     ; $FF00
@@ -809,6 +1264,12 @@ msg_hanging:
     .word DISPGFX_CMD_REG       ; $FF0A
     .word DISPGFX_DATA_REG      ; $FF0C
     .word DISPGFX_STATUS_REG    ; $FF0E
+    .word HDD_STATUS_REG        ; $FF10
+    .word HDD_CMD_REG           ; $FF12
+    .word HDD_DATA_REG          ; $FF14
+    .word FLOPPY_DRIVE_REG      ; $FF16
+    .word TIMER_CTRL_REG        ; $FF18
+    .word IRQC_PENDING_REG      ; $FF1A
 
 
 ; ============================================================
@@ -8,7 +8,7 @@
 ; Memory map (post-boot, kernel running)
 ;
 ;   $0000–$000F   BIOS zero page  (STRPTR, CMPPTR, JMPPTR, KBD_LAST, FLOPPY_DONE,
-;                                   DISPGFX shadow regs, cursor row/col)
+;                                   DISPGFX shadow regs, cursor row/col, HDD_DONE)
 ;   $0010–$00FF   Free zero page  (240 B — kernel / app ZP variables)
 ;   $0100–$01FF   Hardware stack  (256 B — fixed by 6502 architecture)
 ;   $0200–$0209   Device registers (MMIO — 10 bytes, fixed by emulator DEVTABLE)
@@ -16,9 +16,16 @@
 ;   $06BA–$0B69   MONITOR CRAM   (1200 B, 40×30 colour attributes)
 ;   $0B6A–$0F69   Kernel         (2 sectors × 512 B = 1 KB loaded area)
 ;   $0F6A–$1069   KERNELBSS      (256 B — kernel_ipbuf)
-;   $106A–$7FFF   FREE RAM       (~28.5 KB — one contiguous block)
+;   $106A–$7FE6   FREE RAM       (~28.5 KB — one contiguous block; an
+;                                 80-column text mode takes $6000–$7F3F)
+;   $7FE7–$7FEF   BIOS variables (timer ticks, text geometry, buffers,
+;                                 frames, scroll row — zero page is full)
+;   $7FF0–$7FF5   Hard disk registers (MMIO — STATUS, CMD, 4-byte DATA)
+;   $7FF6–$7FF7   Floppy drive select + IRQ pending mask (MMIO)
+;   $7FF8–$7FFB   Timer registers (MMIO — CTRL, STATUS, 2-byte COUNT)
+;   $7FFC–$7FFF   Interrupt controller (MMIO — PENDING, MASK, CAUSE, ACK)
 ;   $8000–$FEFF   BIOS ROM
-;   $FF00–$FF0F   Device address table (16 B — 8 two-byte LE pointers)
+;   $FF00–$FF1B   Device address table (28 B — 14 two-byte LE pointers)
 ;   $FFFA–$FFFF   CPU vectors
 ;
 ; ============================================================
@@ -40,16 +47,27 @@ STRPTR              = $00   ; 2-byte string pointer     (lo=$00, hi=$01)
 CMPPTR              = $02   ; 2-byte compare pointer    (lo=$02, hi=$03)
 JMPPTR              = $04   ; 2-byte jump pointer       (lo=$04, hi=$05)
 KBD_LAST            = $06   ; last keystroke from IRQ handler
-FLOPPY_DONE         = $07   ; set to 1 by IRQ on floppy completion
+FLOPPY_DONE         = $07   ; bit n set by IRQ when drive n completes
 DISPGFX_VRAM_SHADOW = $08   ; 1 byte — temp copy of char being written
 DISPGFX_VRAM_WPTR   = $09   ; 2 bytes ($09-$0A) — running ptr into VRAM
 DISPGFX_CRAM_WPTR   = $0B   ; 2 bytes ($0B-$0C) — running ptr into CRAM
-DISPGFX_CURS_ROW    = $0D   ; 1 byte — current cursor row    (0-29)
-DISPGFX_CURS_COL    = $0E   ; 1 byte — current cursor column (0-39)
-; $0F spare
+DISPGFX_CURS_ROW    = $0D   ; 1 byte — current cursor row    (0-rows-1)
+DISPGFX_CURS_COL    = $0E   ; 1 byte — current cursor column (0-cols-1)
+HDD_DONE            = $0F   ; set to 1 by IRQ on hard disk completion
 
 ; Zero page $10–$FF is free for kernel / app use.
 
+; ----------------------------------------
+; BIOS variables outside zero page
+; ----------------------------------------
+TIMER_TICKS         = $7FE7 ; timer expiries seen by the IRQ handler, wraps
+DISPGFX_TEXT_COLS   = $7FE8 ; text geometry (40 or 80), from the device
+DISPGFX_TEXT_ROWS   = $7FE9 ; text geometry (30, 25 or 50)
+DISPGFX_VRAM_PTR    = $7FEA ; 2 bytes — VRAM in use (DISPGFX_VRAM_BASE/80)
+DISPGFX_CRAM_PTR    = $7FEC ; 2 bytes — CRAM in use (DISPGFX_CRAM_BASE/80)
+DISPGFX_FRAMES      = $7FEE ; frames seen (VBLANK latch), wraps at 256
+DISPGFX_SCROLL_ROW  = $7FEF ; VRAM ring row shown on screen row 0
+
 ; ----------------------------------------
 ; MEMORY-MAPPED DEVICE REGISTERS ($0200–$0209)
 ; The C emulator loads these addresses from the DEVTABLE at $FF00
@@ -66,15 +84,92 @@ DISPGFX_CMD_REG         = $0206
 DISPGFX_DATA_REG        = $0207 ; 2 bytes ($0207-$0208)
 DISPGFX_STATUS_REG      = $0209
 
+; Hard disk: DATA is 4 bytes wide to hold a 32-bit LBA.
+; Kept at the top of RAM so the low register block stays fixed.
+HDD_STATUS_REG          = $7FF0
+HDD_CMD_REG             = $7FF1
+HDD_DATA_REG            = $7FF2 ; 4 bytes ($7FF2-$7FF5)
+
+; Floppy drive select. STATUS/CMD/DATA above talk to the selected drive;
+; a command keeps running on its drive while another one is selected.
+FLOPPY_DRIVE_REG        = $7FF6 ; 0 = A:, 1 = B:, ...
+FLOPPY_IRQ_REG          = $7FF7 ; bit n = drive n completed; write 1s to ACK
+FLOPPY_MAX_DRIVES       = 4
+
+; Interval timer: a 16-bit down counter clocked by the CPU (EMU_CPU_HZ,
+; 1 MHz). Starting it (RUN 0 -> 1) loads COUNT from the reload value;
+; periodic mode reloads on every expiry, one-shot clears RUN.
+TIMER_CTRL_REG          = $7FF8
+TIMER_STATUS_REG        = $7FF9 ; reading clears TIMER_STATUS_EXPIRED
+TIMER_COUNT_REG         = $7FFA ; 2 bytes: write = reload value (lo first),
+                                ; read = count left (lo first, latches hi)
+
+; Timer control bits
+TIMER_CTRL_RUN          = $01
+TIMER_CTRL_PERIODIC     = $02
+TIMER_CTRL_IRQ          = $04 ; IRQ on every expiry
+TIMER_CTRL_DIV1         = $00 ; one tick per CPU cycle
+TIMER_CTRL_DIV16        = $10
+TIMER_CTRL_DIV256       = $20
+TIMER_CTRL_DIV4096      = $30
+
+; Timer status bits
+TIMER_STATUS_EXPIRED    = $01 ; latched on expiry
+TIMER_STATUS_RUNNING    = $80
+
+TIMER_CYCLES_PER_MS     = 1000
+
+; Interrupt controller: every device IRQ sets its source's PENDING bit;
+; the CPU is interrupted while a pending source is also set in MASK.
+; CAUSE is 2 × the first such source in priority order (the IRQC_*
+; bits below, lowest first) or IRQC_CAUSE_NONE, ready to index a
+; table of words. Writing 1s to ACK clears pending bits; the device
+; itself is still acknowledged as before.
+IRQC_PENDING_REG        = $7FFC
+IRQC_MASK_REG           = $7FFD ; 1 = enabled, all 0 at power-on
+IRQC_CAUSE_REG          = $7FFE
+IRQC_ACK_REG            = $7FFF
+
+; Interrupt sources, highest priority first
+IRQC_TIMER              = $01
+IRQC_KBD                = $02
+IRQC_HDD                = $04
+IRQC_FLOPPY             = $08
+IRQC_DISPGFX            = $10
+IRQC_ALL                = $1F
+IRQC_CAUSE_NONE         = $10 ; 8 sources × 2
+
 ; ----------------------------------------
 ; FLOPPY COMMANDS
 ; ----------------------------------------
 FLOPPY_CMD_NO_CMD       = $00
 FLOPPY_CMD_RESET        = $01
 FLOPPY_CMD_SET_DMA_ADDR = $02
-FLOPPY_CMD_STORE_LBA    = $03
+FLOPPY_CMD_STORE_LBA    = $03 ; DATA = 16-bit LE LBA
 FLOPPY_CMD_READ_SECTOR  = $04
 FLOPPY_CMD_WRITE_SECTOR = $05
+FLOPPY_CMD_SET_COUNT    = $06 ; DATA low = sector count (1-255)
+FLOPPY_CMD_READ_MULTI   = $07 ; read COUNT sectors, one IRQ
+FLOPPY_CMD_WRITE_MULTI  = $08 ; write COUNT sectors, one IRQ
+FLOPPY_CMD_FLUSH        = $09 ; write dirty sectors back to the image
+FLOPPY_CMD_SET_QUEUE    = $0A ; DATA = 16-bit address of the queue ring
+FLOPPY_CMD_QUEUE_KICK   = $0B ; run all posted descriptors, one IRQ
+
+; ----------------------------------------
+; FLOPPY COMMAND QUEUE (ring in guest RAM)
+; ----------------------------------------
+FLOPPY_Q_HEAD       = 0   ; next slot the guest fills
+FLOPPY_Q_TAIL       = 1   ; next slot the controller takes
+FLOPPY_Q_DESC       = 2   ; first descriptor
+FLOPPY_QUEUE_SLOTS  = 16
+FLOPPY_QDESC_SIZE   = 8
+FLOPPY_QD_CMD       = 0   ; FLOPPY_CMD_READ_MULTI / FLOPPY_CMD_WRITE_MULTI
+FLOPPY_QD_COUNT     = 1
+FLOPPY_QD_LBA       = 2   ; 16-bit LE
+FLOPPY_QD_DMA       = 4   ; 16-bit LE
+FLOPPY_QD_STATUS    = 6   ; zero when posting
+FLOPPY_QSTAT_DONE   = $80
+FLOPPY_QSTAT_ERROR  = $04
 
 ; ----------------------------------------
 ; FLOPPY STATUS BITS
@@ -84,8 +179,29 @@ FLOPPY_STATUS_BUSY  = $02
 FLOPPY_STATUS_ERROR = $04
 FLOPPY_STATUS_IRQ   = $08
 
+; ----------------------------------------
+; HARD DISK COMMANDS (512-byte sectors, no mechanical delay)
+; ----------------------------------------
+HDD_CMD_NO_CMD          = $00
+HDD_CMD_RESET           = $01
+HDD_CMD_SET_DMA_ADDR    = $02 ; DATA = 16-bit LE address
+HDD_CMD_STORE_LBA       = $03 ; DATA = 32-bit LE LBA
+HDD_CMD_READ_SECTOR     = $04
+HDD_CMD_WRITE_SECTOR    = $05
+HDD_CMD_SET_COUNT       = $06 ; DATA low = sector count (1-255)
+HDD_CMD_READ_MULTI      = $07 ; read COUNT sectors, one IRQ
+HDD_CMD_WRITE_MULTI     = $08 ; write COUNT sectors, one IRQ
+HDD_CMD_FLUSH           = $09 ; write dirty sectors back to the image
+HDD_CMD_IDENTIFY        = $0A ; DATA <- 32-bit LE sector count
+
+; Status bits: same layout as the floppy
+HDD_STATUS_IDLE     = $01
+HDD_STATUS_BUSY     = $02
+HDD_STATUS_ERROR    = $04
+HDD_STATUS_IRQ      = $08
+
 ; ============================================================
-; MONITOR GEOMETRY INFORMATION
+; MONITOR GEOMETRY INFORMATION (default text mode)
 ; ROWS = 30,  COLS = 40
 ; Char width = 8,  Char height = 8
 ; Resolution = 320 × 240 pixels, scale factor = 3
@@ -93,6 +209,7 @@ FLOPPY_STATUS_IRQ   = $08
 ; ============================================================
 DISPGFX_ROWS            = 30
 DISPGFX_COLS            = 40
+DISPGFX_MAX_ROWS        = 50  ; 80×50 mode, see DISPGFX_MODE_*
 
 ; ============================================================
 ; MONITOR COLOR PALETTE
@@ -132,18 +249,75 @@ DISPGFX_CMD_SET_CURSOR  = $04 ; DATA low = col, DATA high = row
 DISPGFX_CMD_CURSOR_ON   = $05 ; enable blinking cursor
 DISPGFX_CMD_CURSOR_OFF  = $06 ; disable cursor
 DISPGFX_CMD_SET_BORDER  = $07 ; DATA low = border colour index (0-15)
+DISPGFX_CMD_SCROLL_UP   = $08 ; DATA low = rows, DATA high = attr for new rows
+DISPGFX_CMD_SCROLL_DOWN = $09 ; DATA low = rows, DATA high = attr for new rows
+DISPGFX_CMD_FILL_RECT   = $0A ; DATA = addr of block: planes,col,row,w,h,chr,attr
+DISPGFX_CMD_COPY_RECT   = $0B ; DATA = addr of block: planes,sc,sr,dc,dr,w,h
+
+; FILL_RECT / COPY_RECT plane select bits
+DISPGFX_PLANE_VRAM      = $01
+DISPGFX_PLANE_CRAM      = $02
+
+; Bitmap mode: 320×240, 4 bpp (left pixel in the high nibble), 160
+; bytes per row. The 38400-byte bitmap lives in the emulator; the guest
+; sees one 2 KB bank at a time through a window in its own RAM.
+DISPGFX_CMD_SET_MODE    = $0C ; DATA low = DISPGFX_MODE_*
+DISPGFX_CMD_SET_WINDOW  = $0D ; DATA = base address of the 2 KB bank window
+DISPGFX_CMD_SET_BANK    = $0E ; DATA low = bank (0-18) mapped into the window
+; Blitter — DATA = addr of a parameter block (x, w are 16-bit LE):
+DISPGFX_CMD_DRAW_LINE   = $0F ; x0,y0,x1,y1,colour
+DISPGFX_CMD_BLIT_FILL   = $10 ; x,y,w,h,colour
+DISPGFX_CMD_BLIT_COPY   = $11 ; srcX,srcY,dstX,dstY,w,h (overlap-safe)
+DISPGFX_CMD_BLIT_IMAGE  = $12 ; src addr,dstX,dstY,w,h,key ($FF = opaque)
+
+DISPGFX_MODE_TEXT       = $00 ; 40×30 characters
+DISPGFX_MODE_BITMAP     = $01
+DISPGFX_MODE_TEXT80X25  = $02 ; 80×25 characters
+DISPGFX_MODE_TEXT80X50  = $03 ; 80×50 characters
+
+DISPGFX_BITMAP_PITCH    = 160
+DISPGFX_BANK_SIZE       = 2048
+DISPGFX_BANKS           = 19  ; last bank is 1536 bytes
+
+DISPGFX_CMD_SET_IRQ     = $13 ; DATA low = DISPGFX_IRQ_* enable mask
+DISPGFX_IRQ_VBLANK      = $01 ; IRQ once per frame
+
+; After the first PRESENT the display shows only what each PRESENT
+; captured; before it, VRAM/CRAM are shown live (tear-free copies).
+DISPGFX_CMD_PRESENT     = $14 ; show the current VRAM/CRAM/bitmap
+
+; SET_MODE (text modes) and GET_GEOMETRY leave the text geometry in DATA:
+; low = cols, high = rows. Use dispgfx_set_mode rather than SET_MODE so
+; putcg and the scroll code follow the new geometry.
+DISPGFX_CMD_GET_GEOMETRY = $15
+
+; Character RAM: 256 glyphs × 8 bytes in guest RAM (glyph n at base +
+; n*8, top row first, MSB = leftmost pixel). Edits show up like VRAM
+; writes. DATA = 0 returns to the built-in font.
+DISPGFX_CMD_SET_CHARRAM = $16 ; DATA = 16-bit LE base of 2 KB glyph RAM
+DISPGFX_CHARRAM_SIZE    = 2048
+
+; Page flip: DATA = addr of block: VRAM base, CRAM base (16-bit LE each).
+; The display switches to them at the next frame; STATUS_FLIP stays set
+; until it has, so don't draw into the old page before it clears.
+; SET_VRAM / SET_CRAM before then cancel the flip and clear STATUS_FLIP.
+DISPGFX_CMD_FLIP        = $17
 
 ; ===========================================================
 ; Monitor Status Register Bits
 ; ===========================================================
 DISPGFX_STATUS_IDLE     = $01
 DISPGFX_STATUS_BUSY     = $02
-DISPGFX_STATUS_VBLANK   = $04 ; set once per frame
+DISPGFX_STATUS_VBLANK   = $04 ; latched once per frame, reading STATUS clears
+DISPGFX_STATUS_FLIP     = $08 ; FLIP pending until the next frame
 
 ; ===========================================================
 ; Monitor Buffers — packed right after device registers
 ; ===========================================================
 DISPGFX_VRAM_BASE       = $020A ; 1200 bytes ($020A–$06B9)
 DISPGFX_CRAM_BASE       = $06BA ; 1200 bytes ($06BA–$0B69)
+; 80-column modes: up to 80×50, at the top of free RAM
+DISPGFX_VRAM80_BASE     = $6000 ; 4000 bytes ($6000–$6F9F)
+DISPGFX_CRAM80_BASE     = $6FA0 ; 4000 bytes ($6FA0–$7F3F)
 
 .endif
@@ -0,0 +1,153 @@
+; ============================================================
+; drives_test.s — floppy_select: each drive has its own disk,
+; transfers on two drives overlap, an empty drive fails
+;
+; Needs blank 1.44 MB images in A: and B:, nothing in C:.
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+
+    ; ── 01: the selected drive reads back ─────────────────────
+    inc TEST_STEP
+    lda #2
+    jsr floppy_select
+    lda FLOPPY_DRIVE_REG
+    cmp #2
+    jsr expect_eq
+
+    ; ── 02: 4 sectors at LBA 100 on A:, others on B: ──────────
+    inc TEST_STEP
+    lda #0
+    ldy #$50
+    jsr _drives_test_write
+    inc TEST_STEP
+    lda #1
+    ldy #$60
+    jsr _drives_test_write
+
+    ; ── 04: each drive reads back its own data ────────────────
+    inc TEST_STEP
+    lda #0
+    jsr floppy_select
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #4
+    ldx #>100
+    ldy #<100
+    jsr floppy_read
+    jsr expect_cc
+    lda #8
+    ldx #>TEST_BUF_B
+    ldy #$50
+    jsr test_verify
+    inc TEST_STEP
+    lda #1
+    jsr floppy_select
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #4
+    ldx #>100
+    ldy #<100
+    jsr floppy_read
+    jsr expect_cc
+    lda #8
+    ldx #>TEST_BUF_B
+    ldy #$60
+    jsr test_verify
+
+    ; ── 06: start a read on A: and B:, wait in reverse order ──
+    inc TEST_STEP
+    lda #0
+    jsr floppy_select
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #4
+    ldx #>100
+    ldy #<100
+    jsr floppy_start_read
+    jsr expect_cc
+    lda #1
+    jsr floppy_select
+    ldx #>TEST_BUF_C
+    jsr test_strptr
+    lda #4
+    ldx #>100
+    ldy #<100
+    jsr floppy_start_read
+    jsr expect_cc
+    jsr floppy_wait         ; B:
+    jsr expect_cc
+    lda #0
+    jsr floppy_select
+    jsr floppy_wait         ; A:
+    jsr expect_cc
+    lda #8
+    ldx #>TEST_BUF_B
+    ldy #$50
+    jsr test_verify
+    lda #8
+    ldx #>TEST_BUF_C
+    ldy #$60
+    jsr test_verify
+
+    ; ── 07: drive C: has no image ─────────────────────────────
+    inc TEST_STEP
+    lda #2
+    jsr floppy_select
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #1
+    ldx #0
+    ldy #0
+    jsr floppy_read
+    jsr expect_cs
+    inc TEST_STEP
+    lda #1
+    ldx #0
+    ldy #0
+    jsr floppy_start_read
+    jsr expect_cc
+    jsr floppy_wait
+    jsr expect_cs
+
+    ; ── 09: A: still works after the failures on C: ───────────
+    inc TEST_STEP
+    lda #0
+    jsr floppy_select
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #1
+    ldx #>100
+    ldy #<100
+    jsr floppy_read
+    jsr expect_cc
+    lda #2
+    ldx #>TEST_BUF_B
+    ldy #$50
+    jsr test_verify
+
+    jmp test_pass
+
+
+; Write 4 sectors of pattern Y to LBA 100 of the drive in A
+_drives_test_write:
+    jsr floppy_select
+    lda #8
+    ldx #>TEST_BUF_A
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #4
+    ldx #>100
+    ldy #<100
+    jsr floppy_write
+    jmp expect_cc
+
+.include "bios.s"
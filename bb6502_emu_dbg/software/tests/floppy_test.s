@@ -0,0 +1,165 @@
+; ============================================================
+; floppy_test.s — floppy_read / floppy_write with 16-bit LBAs
+; and multi-sector (MULTI) transfers
+;
+; Needs a blank 1.44 MB image in drive A:.
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+    sta FLOPPY_DRIVE_REG
+
+    ; ── 01: write 3 sectors at LBA 300 (high byte in use) ─────
+    inc TEST_STEP
+    lda #6
+    ldx #>TEST_BUF_A
+    ldy #$30
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #3
+    ldx #>300
+    ldy #<300
+    jsr floppy_write
+    jsr expect_cc
+
+    ; ── 02: STRPTR advanced past the 3 sectors ────────────────
+    inc TEST_STEP
+    lda STRPTR+1
+    cmp #>(TEST_BUF_A + 3 * 512)
+    jsr expect_eq
+
+    ; ── 03: write 1 sector at LBA 44, same low byte as 300 ────
+    inc TEST_STEP
+    lda #2
+    ldx #>TEST_BUF_A
+    ldy #$90
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #1
+    ldx #>44
+    ldy #<44
+    jsr floppy_write
+    jsr expect_cc
+
+    ; ── 04: read LBA 300-302 back in one transfer ─────────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #3
+    ldx #>300
+    ldy #<300
+    jsr floppy_read
+    jsr expect_cc
+    lda #6
+    ldx #>TEST_BUF_B
+    ldy #$30
+    jsr test_verify
+
+    ; ── 05: LBA 44 kept its own data ──────────────────────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #1
+    ldx #>44
+    ldy #<44
+    jsr floppy_read
+    jsr expect_cc
+    lda #2
+    ldx #>TEST_BUF_B
+    ldy #$90
+    jsr test_verify
+
+    ; ── 06: a run starting mid-way (LBA 301-302) ──────────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #2
+    ldx #>301
+    ldy #<301
+    jsr floppy_read
+    jsr expect_cc
+    lda #4
+    ldx #>TEST_BUF_B
+    ldy #$32
+    jsr test_verify
+
+    ; ── 07: the last sector reads, one past the end does not ──
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #1
+    ldx #>2879
+    ldy #<2879
+    jsr floppy_read
+    jsr expect_cc
+    inc TEST_STEP
+    lda #2
+    ldx #>2879
+    ldy #<2879
+    jsr floppy_read
+    jsr expect_cs
+    inc TEST_STEP
+    lda #1
+    ldx #>2880
+    ldy #<2880
+    jsr floppy_read
+    jsr expect_cs
+
+    ; ── 0A: a count of 128 is refused before any transfer ─────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    lda #128
+    ldx #0
+    ldy #0
+    jsr floppy_read
+    jsr expect_cs
+    inc TEST_STEP
+    lda #128
+    ldx #0
+    ldy #0
+    jsr floppy_write
+    jsr expect_cs
+    inc TEST_STEP
+    lda #128
+    ldx #0
+    ldy #0
+    jsr floppy_start_read
+    jsr expect_cs
+    inc TEST_STEP
+    lda STRPTR+1
+    cmp #>TEST_BUF_B
+    jsr expect_eq
+
+    ; ── 0E: start + wait reads the same run ───────────────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_C
+    jsr test_strptr
+    lda #3
+    ldx #>300
+    ldy #<300
+    jsr floppy_start_read
+    jsr expect_cc
+    jsr floppy_wait
+    jsr expect_cc
+    lda #6
+    ldx #>TEST_BUF_C
+    ldy #$30
+    jsr test_verify
+
+    ; ── 0F: flush ─────────────────────────────────────────────
+    inc TEST_STEP
+    jsr floppy_flush
+    jsr expect_cc
+
+    jmp test_pass
+
+.include "bios.s"
@@ -0,0 +1,187 @@
+; ============================================================
+; hdd_test.s — hdd_identify, hdd_read / hdd_write with 32-bit
+; LBAs, and their error paths
+;
+; Needs a blank 1 MiB hard disk (2048 sectors).
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+HDD_TEST_SECTORS = 2048
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+
+    ; ── 01: IDENTIFY reports the disk size ────────────────────
+    inc TEST_STEP
+    ldx #<TEST_LBA
+    ldy #>TEST_LBA
+    jsr hdd_identify
+    lda TEST_LBA
+    cmp #<HDD_TEST_SECTORS
+    jsr expect_eq
+    lda TEST_LBA+1
+    cmp #>HDD_TEST_SECTORS
+    jsr expect_eq
+    lda TEST_LBA+2
+    ora TEST_LBA+3
+    jsr expect_eq
+
+    ; ── 02: write the last 3 sectors ──────────────────────────
+    inc TEST_STEP
+    lda #6
+    ldx #>TEST_BUF_A
+    ldy #$40
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    ldx #$FD                ; LBA 2045 = $000007FD
+    ldy #$07
+    jsr _hdd_test_lba
+    lda #3
+    jsr _hdd_test_write
+    jsr expect_cc
+
+    ; ── 03: STRPTR advanced past the 3 sectors ────────────────
+    inc TEST_STEP
+    lda STRPTR+1
+    cmp #>(TEST_BUF_A + 3 * 512)
+    jsr expect_eq
+
+    ; ── 04: write 1 sector at LBA 253, same low byte ──────────
+    inc TEST_STEP
+    lda #2
+    ldx #>TEST_BUF_A
+    ldy #$A0
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    ldx #$FD
+    ldy #$00
+    jsr _hdd_test_lba
+    lda #1
+    jsr _hdd_test_write
+    jsr expect_cc
+
+    ; ── 05: read LBA 2045-2047 back in one transfer ───────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    ldx #$FD
+    ldy #$07
+    jsr _hdd_test_lba
+    lda #3
+    jsr _hdd_test_read
+    jsr expect_cc
+    lda #6
+    ldx #>TEST_BUF_B
+    ldy #$40
+    jsr test_verify
+
+    ; ── 06: LBA 253 kept its own data ─────────────────────────
+    inc TEST_STEP
+    jsr _hdd_test_read_253
+
+    ; ── 07: a run that crosses the end fails ──────────────────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    ldx #$FF                ; LBA 2047
+    ldy #$07
+    jsr _hdd_test_lba
+    lda #2
+    jsr _hdd_test_read
+    jsr expect_cs
+
+    ; ── 08: the upper LBA bytes count: $000107FD and ──────────
+    ;        $010000FD are past the end, not LBA 2045 / 253
+    inc TEST_STEP
+    ldx #$FD
+    ldy #$07
+    jsr _hdd_test_lba
+    lda #$01
+    sta TEST_LBA+2
+    lda #1
+    jsr _hdd_test_read
+    jsr expect_cs
+    inc TEST_STEP
+    ldx #$FD
+    ldy #$00
+    jsr _hdd_test_lba
+    lda #$01
+    sta TEST_LBA+3
+    lda #1
+    jsr _hdd_test_write
+    jsr expect_cs
+
+    ; ── 0A: a count of 128 is refused before any transfer ─────
+    inc TEST_STEP
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    ldx #$00
+    ldy #$00
+    jsr _hdd_test_lba
+    lda #128
+    jsr _hdd_test_read
+    jsr expect_cs
+    inc TEST_STEP
+    lda #128
+    jsr _hdd_test_write
+    jsr expect_cs
+    inc TEST_STEP
+    lda STRPTR+1
+    cmp #>TEST_BUF_B
+    jsr expect_eq
+
+    ; ── 0D: the errors left nothing behind ────────────────────
+    inc TEST_STEP
+    jsr _hdd_test_read_253
+
+    ; ── 0E: flush ─────────────────────────────────────────────
+    inc TEST_STEP
+    jsr hdd_flush
+    jsr expect_cc
+
+    jmp test_pass
+
+
+; TEST_LBA = X + (Y << 8)
+_hdd_test_lba:
+    stx TEST_LBA
+    sty TEST_LBA+1
+    lda #$00
+    sta TEST_LBA+2
+    sta TEST_LBA+3
+    rts
+
+; hdd_read / hdd_write of A sectors at TEST_LBA
+_hdd_test_read:
+    ldx #<TEST_LBA
+    ldy #>TEST_LBA
+    jmp hdd_read
+
+_hdd_test_write:
+    ldx #<TEST_LBA
+    ldy #>TEST_LBA
+    jmp hdd_write
+
+; Read LBA 253 and check it holds what step 04 wrote
+_hdd_test_read_253:
+    ldx #>TEST_BUF_B
+    jsr test_strptr
+    ldx #$FD
+    ldy #$00
+    jsr _hdd_test_lba
+    lda #1
+    jsr _hdd_test_read
+    jsr expect_cc
+    lda #2
+    ldx #>TEST_BUF_B
+    ldy #$A0
+    jmp test_verify
+
+.include "bios.s"
@@ -0,0 +1,166 @@
+; ============================================================
+; irqc_test.s — interrupt controller: PENDING latches whatever
+; the mask, CAUSE picks the unmasked source of highest priority,
+; ACK clears only the bits written, one IRQ entry serves every
+; pending source
+;
+; Needs a blank 1.44 MB image in A:.
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+IRQC_TEST_BOTH = IRQC_TIMER | IRQC_FLOPPY
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+    sta FLOPPY_DRIVE_REG
+
+    ; ── 01: reset enabled every source ────────────────────────
+    inc TEST_STEP
+    lda IRQC_MASK_REG
+    cmp #IRQC_ALL
+    jsr expect_eq
+
+    ; ── 02: masked sources latch but have no CAUSE ────────────
+    inc TEST_STEP
+    jsr _irqc_test_raise_both
+    lda IRQC_CAUSE_REG
+    cmp #IRQC_CAUSE_NONE
+    jsr expect_eq
+
+    ; ── 03: timer comes before floppy ─────────────────────────
+    inc TEST_STEP
+    lda #IRQC_TEST_BOTH
+    sta IRQC_MASK_REG
+    lda IRQC_CAUSE_REG
+    cmp #(2 * 0)
+    jsr expect_eq
+
+    ; ── 04: with the timer masked, floppy is the cause ────────
+    inc TEST_STEP
+    lda #IRQC_FLOPPY
+    sta IRQC_MASK_REG
+    lda IRQC_CAUSE_REG
+    cmp #(2 * 3)
+    jsr expect_eq
+
+    ; ── 05: ACK clears only the bits written ──────────────────
+    inc TEST_STEP
+    lda #IRQC_FLOPPY
+    sta IRQC_ACK_REG
+    lda IRQC_CAUSE_REG
+    cmp #IRQC_CAUSE_NONE
+    jsr expect_eq
+    lda IRQC_PENDING_REG
+    and #IRQC_TEST_BOTH
+    cmp #IRQC_TIMER
+    jsr expect_eq
+    inc TEST_STEP
+    lda #IRQC_TEST_BOTH
+    sta IRQC_MASK_REG
+    lda IRQC_CAUSE_REG
+    cmp #(2 * 0)
+    jsr expect_eq
+    lda #IRQC_TIMER
+    sta IRQC_ACK_REG
+    lda IRQC_PENDING_REG
+    and #IRQC_TEST_BOTH
+    jsr expect_eq
+
+    ; ── 07: the device keeps its own status after the ACK ─────
+    inc TEST_STEP
+    lda FLOPPY_IRQ_REG
+    cmp #$01
+    jsr expect_eq
+    sta FLOPPY_IRQ_REG
+
+    ; ── 08: one IRQ entry runs both handlers ──────────────────
+    inc TEST_STEP
+    lda #$00
+    sta TIMER_TICKS
+    jsr _irqc_test_raise_both
+    lda #IRQC_ALL
+    sta IRQC_MASK_REG
+    cli
+    nop
+    nop
+    sei
+    lda TIMER_TICKS
+    cmp #1
+    jsr expect_eq
+    lda FLOPPY_DONE
+    and #$01
+    jsr expect_ne
+    lda IRQC_PENDING_REG
+    and #IRQC_TEST_BOTH
+    jsr expect_eq
+
+    ; ── 09: a masked source waits, unmasking delivers it ──────
+    inc TEST_STEP
+    lda #$00
+    sta IRQC_MASK_REG
+    sta TIMER_TICKS
+    jsr _irqc_test_timer
+    cli
+    ldx #$00
+@masked:
+    dex
+    bne @masked
+    lda TIMER_TICKS
+    jsr expect_eq
+    inc TEST_STEP
+    lda #IRQC_TIMER
+    sta IRQC_MASK_REG
+    nop
+    nop
+    sei
+    lda TIMER_TICKS
+    cmp #1
+    jsr expect_eq
+
+    lda #IRQC_ALL
+    sta IRQC_MASK_REG
+    jmp test_pass
+
+
+; ============================================================
+; _irqc_test_raise_both — mask everything, then let a one-shot
+; timer and a floppy read finish, leaving both pending.
+; Returns with IRQs disabled.
+; ============================================================
+_irqc_test_raise_both:
+    lda #$00
+    sta IRQC_MASK_REG
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #1
+    ldx #0
+    ldy #0
+    jsr floppy_start_read   ; leaves IRQs on; the mask holds them
+    sei
+@floppy:
+    lda IRQC_PENDING_REG
+    and #IRQC_FLOPPY
+    beq @floppy
+    ; fall through
+
+; Start a short one-shot timer with IRQ and wait for it to be
+; pending.  STATUS is not read, so the handler sees EXPIRED.
+_irqc_test_timer:
+    lda #<100
+    sta TIMER_COUNT_REG
+    lda #>100
+    sta TIMER_COUNT_REG+1
+    lda #(TIMER_CTRL_RUN | TIMER_CTRL_IRQ)
+    sta TIMER_CTRL_REG
+@timer:
+    lda IRQC_PENDING_REG
+    and #IRQC_TIMER
+    beq @timer
+    rts
+
+.include "bios.s"
@@ -0,0 +1,104 @@
+; ============================================================
+; queue_test.s — floppy command queue: descriptors run out of
+; order, each gets its status, TAIL catches up with HEAD
+;
+; Needs a blank 1.44 MB image in A:.
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+QUEUE_TEST_RING = $5000
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+    sta FLOPPY_DRIVE_REG
+
+    ; ── 01: one sector at LBA 1000, another at LBA 10 ─────────
+    inc TEST_STEP
+    lda #2
+    ldx #>TEST_BUF_A
+    ldy #$70
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #1
+    ldx #>1000
+    ldy #<1000
+    jsr floppy_write
+    jsr expect_cc
+    lda #2
+    ldx #>TEST_BUF_A
+    ldy #$80
+    jsr test_fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #1
+    ldx #>10
+    ldy #<10
+    jsr floppy_write
+    jsr expect_cc
+
+    ; ── 03: post both reads (far cylinder first) and a bad one ─
+    inc TEST_STEP
+    lda #<QUEUE_TEST_RING
+    ldx #>QUEUE_TEST_RING
+    jsr floppy_queue_init
+    ldx #$00
+@copy:
+    lda _queue_test_descs,x
+    sta QUEUE_TEST_RING + FLOPPY_Q_DESC,x
+    inx
+    cpx #(3 * FLOPPY_QDESC_SIZE)
+    bne @copy
+    lda #3
+    sta QUEUE_TEST_RING + FLOPPY_Q_HEAD
+    jsr floppy_queue_kick
+    jsr expect_cc
+    lda QUEUE_TEST_RING + FLOPPY_Q_TAIL
+    cmp #3
+    jsr expect_eq
+
+    ; ── 04: statuses: two done, the empty one an error ────────
+    inc TEST_STEP
+    lda QUEUE_TEST_RING + FLOPPY_Q_DESC + FLOPPY_QD_STATUS
+    cmp #FLOPPY_QSTAT_DONE
+    jsr expect_eq
+    lda QUEUE_TEST_RING + FLOPPY_Q_DESC + FLOPPY_QDESC_SIZE + FLOPPY_QD_STATUS
+    cmp #FLOPPY_QSTAT_DONE
+    jsr expect_eq
+    lda QUEUE_TEST_RING + FLOPPY_Q_DESC + 2 * FLOPPY_QDESC_SIZE + FLOPPY_QD_STATUS
+    cmp #(FLOPPY_QSTAT_DONE | FLOPPY_QSTAT_ERROR)
+    jsr expect_eq
+
+    ; ── 05: each read landed where its descriptor said ────────
+    inc TEST_STEP
+    lda #2
+    ldx #>TEST_BUF_B
+    ldy #$70
+    jsr test_verify
+    lda #2
+    ldx #>TEST_BUF_C
+    ldy #$80
+    jsr test_verify
+
+    jmp test_pass
+
+
+.segment "BOOTRODATA"
+; cmd, count, LBA, DMA address, status
+_queue_test_descs:
+    .byte FLOPPY_CMD_READ_MULTI, 1
+    .word 1000, TEST_BUF_B
+    .byte 0, 0
+    .byte FLOPPY_CMD_READ_MULTI, 1
+    .word 10, TEST_BUF_C
+    .byte 0, 0
+    .byte FLOPPY_CMD_READ_MULTI, 0
+    .word 20, TEST_BUF_A
+    .byte 0, 0
+
+.include "bios.s"
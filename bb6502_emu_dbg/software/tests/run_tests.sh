@@ -0,0 +1,44 @@
+#!/bin/sh
+# ============================================================
+# run_tests.sh — boot each guest test ROM headless, check it passed
+#
+# usage: run_tests.sh <emulator> <test.bin>...
+#
+# Every test gets fresh disks: blank 1.44 MB floppies in A: and
+# B: (C: and D: stay empty) and a new 1 MiB hard disk.  A test
+# prints "PASS" or "FAIL <step>" on the text display and halts;
+# the emulator stops after TEST_CYCLES.
+# ============================================================
+
+EMU=$1
+shift
+TEST_CYCLES=${TEST_CYCLES:-20000000}
+FLOPPY_SIZE=1474560
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+failed=0
+for rom in "$@"; do
+    name=$(basename "$rom" .bin)
+    rm -f "$WORK"/*
+    truncate -s $FLOPPY_SIZE "$WORK/a.img" "$WORK/b.img"
+    "$EMU" "$rom" --headless -t instant \
+        -f "$WORK/a.img" -f "$WORK/b.img" \
+        -H "$WORK/hdd.img" --hdd-size 1 \
+        --cycles $TEST_CYCLES --text-out "$WORK/out.txt" \
+        > "$WORK/log.txt" 2>&1
+    if grep -q '^PASS' "$WORK/out.txt" 2>/dev/null; then
+        echo "PASS  $name"
+    else
+        echo "FAIL  $name: $(head -n 1 "$WORK/out.txt" 2>/dev/null)"
+        sed 's/^/      /' "$WORK/log.txt"
+        failed=$((failed + 1))
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "$failed of $# tests failed"
+    exit 1
+fi
+echo "all $# tests passed"
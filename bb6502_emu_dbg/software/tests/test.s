@@ -0,0 +1,171 @@
+; ============================================================
+; test.s — helpers shared by the guest tests
+;
+; A test is a ROM whose _bootloader runs a list of checks and
+; ends in test_pass or test_fail; both print to the text display
+; and halt.  run_tests.sh looks for the "PASS" line.
+;
+; Number the checks by incrementing TEST_STEP before each one, so
+; a failure names the check that failed ("FAIL 03").  The expect_*
+; calls jump straight to test_fail, abandoning the stack.
+; ============================================================
+
+.ifndef TEST_INCLUDED
+TEST_INCLUDED = 1
+
+.include "vars.s"
+
+TEST_STEP   = $10   ; number of the check being run
+TEST_PTR    = $11   ; 2 bytes — test_fill / test_verify cursor
+TEST_PAGES  = $13   ; pages left to fill or verify
+TEST_SEED   = $14   ; pattern of the current page
+TEST_LBA    = $15   ; 4 bytes — LE LBA for hdd_read / hdd_write
+
+; Sector buffers (512 B each) in free RAM
+TEST_BUF_A  = $2000
+TEST_BUF_B  = $3000
+TEST_BUF_C  = $4000
+
+.segment "BOOTLOADER"
+
+; ============================================================
+; test_pass / test_fail — report the result and halt
+; ============================================================
+test_pass:
+    lda #<msg_test_pass
+    sta STRPTR
+    lda #>msg_test_pass
+    sta STRPTR+1
+    jsr puts
+    jmp hang
+
+test_fail:
+    sei
+    lda #<msg_test_fail
+    sta STRPTR
+    lda #>msg_test_fail
+    sta STRPTR+1
+    jsr puts
+    lda TEST_STEP
+    lsr a
+    lsr a
+    lsr a
+    lsr a
+    jsr _test_hex_digit
+    lda TEST_STEP
+    jsr _test_hex_digit
+    lda #$0D
+    jsr putc
+    lda #$0A
+    jsr putc
+    jmp hang
+
+_test_hex_digit:
+    and #$0F
+    tax
+    lda _test_hex,x
+    jmp putc
+
+_test_hex:
+    .byte "0123456789ABCDEF"
+
+
+; ============================================================
+; expect_cc / expect_cs / expect_eq / expect_ne — fail the test
+; unless the flag the call is named after is as expected
+;
+; jsr leaves the flags alone, so call them right after the
+; operation or compare being checked.
+; ============================================================
+expect_cc:
+    bcs test_fail
+    rts
+
+expect_cs:
+    bcc test_fail
+    rts
+
+expect_eq:
+    bne test_fail
+    rts
+
+expect_ne:
+    beq test_fail
+    rts
+
+
+; ============================================================
+; test_fill — write the test pattern
+; test_verify — fail the test unless the pattern is there
+;
+; Byte k of page n is k EOR (seed + n), so each page of each
+; seed differs: a sector read from the wrong LBA or landed at
+; the wrong address shows up.
+;
+; In:  A = number of pages
+;      X = first page (high byte of the address)
+;      Y = seed of the first page
+;
+; Out: A, Y clobbered.
+; ============================================================
+test_fill:
+    jsr _test_pattern_start
+@page:
+    ldy #$00
+@byte:
+    tya
+    eor TEST_SEED
+    sta (TEST_PTR),y
+    iny
+    bne @byte
+    inc TEST_SEED
+    inc TEST_PTR+1
+    dec TEST_PAGES
+    bne @page
+    rts
+
+test_verify:
+    jsr _test_pattern_start
+@page:
+    ldy #$00
+@byte:
+    tya
+    eor TEST_SEED
+    cmp (TEST_PTR),y
+    bne test_fail
+    iny
+    bne @byte
+    inc TEST_SEED
+    inc TEST_PTR+1
+    dec TEST_PAGES
+    bne @page
+    rts
+
+_test_pattern_start:
+    sta TEST_PAGES
+    stx TEST_PTR+1
+    sty TEST_SEED
+    lda #$00
+    sta TEST_PTR
+    rts
+
+
+; ============================================================
+; test_strptr — point STRPTR at a page
+;
+; In:  X = page.  Out: A clobbered.
+; ============================================================
+test_strptr:
+    lda #$00
+    sta STRPTR
+    stx STRPTR+1
+    rts
+
+
+.segment "BOOTRODATA"
+msg_test_pass:
+    .byte "PASS", $0D, $0A, $00
+msg_test_fail:
+    .byte "FAIL ", $00
+
+.endif
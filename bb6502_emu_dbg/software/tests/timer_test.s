@@ -0,0 +1,174 @@
+; ============================================================
+; timer_test.s — one-shot and periodic timer, timer_delay, and
+; a DMA over the register page leaving the timer alone
+;
+; Needs a blank 1.44 MB image in A:.
+; ============================================================
+
+.include "vars.s"
+.include "test.s"
+
+TIMER_TEST_DMA_PAGE = $7E   ; one sector up to $7FFF: vars + registers
+
+.segment "BOOTLOADER"
+
+_bootloader:
+    lda #$00
+    sta TEST_STEP
+    sta FLOPPY_DRIVE_REG
+
+    ; ── 01: one-shot: running, counting down from RELOAD ──────
+    inc TEST_STEP
+    lda #<500
+    sta TIMER_COUNT_REG
+    lda #>500
+    sta TIMER_COUNT_REG+1
+    lda #TIMER_CTRL_RUN
+    sta TIMER_CTRL_REG
+    lda TIMER_STATUS_REG
+    cmp #TIMER_STATUS_RUNNING
+    jsr expect_eq
+    inc TEST_STEP
+    lda TIMER_COUNT_REG     ; latches the high byte
+    lda TIMER_COUNT_REG+1
+    cmp #>500
+    jsr expect_eq
+
+    ; ── 03: one-shot expiry stops the timer ───────────────────
+    inc TEST_STEP
+    jsr _timer_test_wait_expired
+    lda TIMER_CTRL_REG
+    jsr expect_eq
+    lda TIMER_STATUS_REG    ; EXPIRED cleared by the read above
+    jsr expect_eq
+    lda TIMER_COUNT_REG
+    jsr expect_eq
+    lda TIMER_COUNT_REG+1
+    jsr expect_eq
+
+    ; ── 04: the count runs at the divided rate ────────────────
+    ;        1000 ticks of 16 cycles; ~1300 cycles later about
+    ;        80 ticks are gone
+    inc TEST_STEP
+    lda #<1000
+    sta TIMER_COUNT_REG
+    lda #>1000
+    sta TIMER_COUNT_REG+1
+    lda #(TIMER_CTRL_RUN | TIMER_CTRL_DIV16)
+    sta TIMER_CTRL_REG
+    ldx #$00
+@spin:
+    dex
+    bne @spin
+    lda TIMER_COUNT_REG
+    tax
+    lda TIMER_COUNT_REG+1
+    cmp #>880
+    jsr expect_eq
+    cpx #<880
+    jsr expect_cs           ; count >= 880
+    cpx #<940
+    jsr expect_cc           ; count < 940
+
+    ; ── 05: stopping freezes the count ────────────────────────
+    inc TEST_STEP
+    lda #$00
+    sta TIMER_CTRL_REG
+    lda TIMER_STATUS_REG
+    jsr expect_eq
+    lda TIMER_COUNT_REG
+    tax
+    ldy #$00
+@idle:
+    dey
+    bne @idle
+    cpx TIMER_COUNT_REG
+    jsr expect_eq
+
+    ; ── 06: periodic keeps running across expiries ────────────
+    inc TEST_STEP
+    lda #<200
+    sta TIMER_COUNT_REG
+    lda #>200
+    sta TIMER_COUNT_REG+1
+    lda #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC)
+    sta TIMER_CTRL_REG
+    jsr _timer_test_wait_expired
+    jsr _timer_test_wait_expired
+    jsr _timer_test_wait_expired
+    lda TIMER_CTRL_REG
+    cmp #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC)
+    jsr expect_eq
+    lda TIMER_STATUS_REG
+    and #TIMER_STATUS_RUNNING
+    jsr expect_ne
+    lda #$00
+    sta TIMER_CTRL_REG
+
+    ; ── 07: timer_delay takes one IRQ per millisecond ─────────
+    inc TEST_STEP
+    lda TIMER_TICKS
+    clc
+    adc #5
+    pha
+    lda #5
+    jsr timer_delay
+    pla
+    cmp TIMER_TICKS
+    jsr expect_eq
+    lda TIMER_CTRL_REG
+    jsr expect_eq
+
+    ; ── 08: a DMA over $7E00-$7FFF fills RAM and skips the ────
+    ;        registers: every byte is RUN | PERIODIC | IRQ
+    inc TEST_STEP
+    ldx #$00
+    lda #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC | TIMER_CTRL_IRQ)
+@fill:
+    sta TEST_BUF_A,x
+    sta TEST_BUF_A+$100,x
+    inx
+    bne @fill
+    ldx #>TEST_BUF_A
+    jsr test_strptr
+    lda #1
+    ldx #0
+    ldy #20
+    jsr floppy_write
+    jsr expect_cc
+    ldx #TIMER_TEST_DMA_PAGE
+    jsr test_strptr
+    lda #1
+    ldx #0
+    ldy #20
+    jsr floppy_read
+    jsr expect_cc
+    inc TEST_STEP
+    lda TIMER_TEST_DMA_PAGE * $100
+    cmp #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC | TIMER_CTRL_IRQ)
+    jsr expect_eq
+    lda HDD_STATUS_REG-1    ; last RAM byte below the registers
+    cmp #(TIMER_CTRL_RUN | TIMER_CTRL_PERIODIC | TIMER_CTRL_IRQ)
+    jsr expect_eq
+    inc TEST_STEP
+    lda TIMER_CTRL_REG
+    jsr expect_eq
+    lda TIMER_STATUS_REG
+    jsr expect_eq
+    lda IRQC_MASK_REG
+    cmp #IRQC_ALL
+    jsr expect_eq
+    lda FLOPPY_DRIVE_REG
+    jsr expect_eq
+
+    jmp test_pass
+
+
+; Spin until the timer expires (reading STATUS clears the latch)
+_timer_test_wait_expired:
+    lda TIMER_STATUS_REG
+    and #TIMER_STATUS_EXPIRED
+    beq _timer_test_wait_expired
+    rts
+
+.include "bios.s"
@@ -15,6 +15,7 @@
 #include <limits.h>
 #include <string.h>
 // Project includes
+#include "blkdev.h"
 #include "debugger.h"
 #include "fake6502.h"
 
@@ -83,6 +84,7 @@ static void dbgRemoveBreakpoint(char **cmdtoks, size_t cmdtoksiz);
 // Variables
 static bool dbgRunning, dbgInsideTerminal, dbgCurrentlyAtBp;
 static char dbgCmdBuf[100], *dbgBinFileName, *dbgSrcFileName, *dbgFloppyFile;
+static blkdev_t dbgFlpDev; // mmap'd floppy image, base == NULL when none
 #define MAX_SYM_FILES 16
 static char *dbgSymFileNames[MAX_SYM_FILES];
 static int dbgNofSymFiles;
@@ -168,6 +170,10 @@ void dbgInit(int argc, char **argv) {
     dbgReadDbgSyms(dbgSymFileNames[i]);
   }
   dbgConsoleEcho("Loading floppy img from %s\n", dbgFloppyFile);
+  if (dbgFloppyFile && blkdevOpen(&dbgFlpDev, dbgFloppyFile, 0, 256, 0) < 0) {
+    dbgConsoleEcho("\tcould not map %s: %s\n", dbgFloppyFile, strerror(errno));
+    dbgFloppyFile = NULL;
+  }
   dbgConsoleEcho("Loaded %d symbols total\n", dbgNofSyms);
   dbgConsoleEcho("uartInReg=%04hx\n", dbgUartInReg);
   dbgConsoleEcho("uartOutReg=%04hx\n", dbgUartOutReg);
@@ -193,6 +199,9 @@ void dbgCleanup(void) {
   }
   free(dbgBpList);
   free(dbgSymbols);
+  if (dbgFlpDev.base) {
+    blkdevClose(&dbgFlpDev);
+  }
   endwin();
   return;
 }
@@ -1212,23 +1221,31 @@ static void dbgRemoveBreakpoint(char **cmdtoks, size_t cmdtoksiz) {
   return;
 }
 
+// Clamp a sector transfer to both the image and the 64K address space.
+// Returns the number of bytes to copy.
+static size_t dbgFloppyXferLen(uint8_t lba, uint8_t count, uint16_t dmaAddr) {
+  if (lba >= dbgFlpDev.nSectors) {
+    return 0;
+  }
+  if (count > dbgFlpDev.nSectors - lba) {
+    count = dbgFlpDev.nSectors - lba;
+  }
+  size_t totalBytes = (size_t)count * 256;
+  if (totalBytes > 0x10000 - (size_t)dmaAddr) {
+    totalBytes = 0x10000 - (size_t)dmaAddr;
+  }
+  return totalBytes;
+}
+
 static void dbgFloppyRead() {
   if (!dbgFloppyFile) {
     return;
   }
-  uint8_t sectorCount = read6502(dbgFlpSecReg); // was commented out
+  uint8_t sectorCount = read6502(dbgFlpSecReg);
   uint16_t dmaAddr = read6502(dbgFlpDmaReg) | read6502(dbgFlpDmaReg + 1) << 8;
   uint8_t lbaAddr = read6502(dbgFlpLbaReg);
-  size_t totalBytes = (size_t)sectorCount * 256; // was hardcoded to 256
-  uint8_t *buf = malloc(totalBytes); 
-  if (!buf)
-    return;
-  FILE *f = fopen(dbgFloppyFile, "rb");
-  fseek(f, lbaAddr * 256, SEEK_SET);
-  fread(buf, 1, totalBytes, f);
-  memcpy(&dbgMEM6502[dmaAddr], buf, totalBytes);
-  free(buf);
-  fclose(f);
+  size_t totalBytes = dbgFloppyXferLen(lbaAddr, sectorCount, dmaAddr);
+  memcpy(&dbgMEM6502[dmaAddr], blkdevSector(&dbgFlpDev, lbaAddr), totalBytes);
   write6502(dbgIxReg, (read6502(dbgIxReg) & 0b11000111) | 0b00001000);
   irq6502();
 }
@@ -1237,19 +1254,12 @@ static void dbgFloppyWrite() {
   if (!dbgFloppyFile) {
     return;
   }
-  uint8_t sectorCount = read6502(dbgFlpSecReg); // was commented out
+  uint8_t sectorCount = read6502(dbgFlpSecReg);
   uint16_t dmaAddr = read6502(dbgFlpDmaReg) | read6502(dbgFlpDmaReg + 1) << 8;
   uint8_t lbaAddr = read6502(dbgFlpLbaReg);
-  size_t totalBytes = (size_t)sectorCount * 256; // was hardcoded to 256
-  uint8_t *buf = malloc(totalBytes);
-  if (!buf)
-    return;
-  memcpy(buf, &dbgMEM6502[dmaAddr], totalBytes);
-  FILE *f = fopen(dbgFloppyFile, "rb+");
-  fseek(f, lbaAddr * 256, SEEK_SET);
-  fwrite(buf, 1, totalBytes, f);
-  free(buf);
-  fclose(f);
+  size_t totalBytes = dbgFloppyXferLen(lbaAddr, sectorCount, dmaAddr);
+  memcpy(blkdevSector(&dbgFlpDev, lbaAddr), &dbgMEM6502[dmaAddr], totalBytes);
+  blkdevMarkDirty(&dbgFlpDev, lbaAddr, (totalBytes + 255) / 256);
   write6502(dbgIxReg, (read6502(dbgIxReg) & 0b11000111) | 0b00001000);
   irq6502();
 }